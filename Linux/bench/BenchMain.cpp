@@ -0,0 +1,438 @@
+/*****************************************************************
+ * \file	BenchMain.cpp
+ * \brief	Benchmark cpp, from where main() is executed to run the 'ACasinoGame' benchmarks
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "Benchmark.hpp"
+
+#include "ParticleSystem.hpp"
+#include "PolyParticleShape.hpp"
+#include "ParticleBatch.hpp"
+#include "MathModule.hpp"
+#include "TextShape.hpp"
+#include "ButtonShape.hpp"
+#include "BoxShape.hpp"
+#include "RenderQueue.hpp"
+#include "WindowModel.hpp"
+#include "HitTestGrid.hpp"
+#include "CreditJournal.hpp"
+#include "TimerWheel.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace {
+	const sf::Vector2u areaSize(800, 600);
+
+	bool neverDies(const ParticleSystem& particleSystem, ParticleSystem::Index index)
+	{
+		//evaluated for every particle, but never met:
+		return particleSystem.getPosition(index).x < -1e30f;
+	}
+
+	void removeJournal(const std::string& path)
+	{
+		std::remove((path + ".journal").c_str());
+		std::remove((path + ".snapshot").c_str());
+	}
+
+	void benchParticleUpdate(Benchmark& benchmark, const std::string& name, ParticleSystem::Kinematics kinematics)
+	{
+		for (std::size_t size : benchmark.getSizes()) {
+			ParticleSystem particleSystem;
+			particleSystem.reserve(size);
+
+			std::vector<float> values(size);
+			for (std::size_t i = 0; i < size; i++) {
+				particleSystem.addParticle();
+			}
+			MathModule::fillRandom(values.data(), size, 0.25f * areaSize.y, 0.8f * areaSize.y);
+			for (std::size_t i = 0; i < size; i++) {
+				ParticleSystem::State state;
+				state.position = { 0, values[i] };
+				state.velocity = { 275, 0 };
+				state.acceleration = { -115, 0 };
+				particleSystem.setBirthState(i, state);
+			}
+			particleSystem.setKinematics(kinematics);
+			if (kinematics == ParticleSystem::Analytic) {
+				//a death boundary which is never crossed, the death times are predicted but never reached:
+				particleSystem.setDeathBoundary({ 0, 1 }, -1);
+			}
+			else {
+				particleSystem.setDeathCondition(ParticleSystem::DeathCondition::fromFunction<&neverDies>());
+			}
+			particleSystem.rebirthAll();
+
+			benchmark.run(name, size, [&]() {
+				particleSystem.update(1 / 60.0f);
+			});
+		}
+	}
+
+	void benchSnapshotWrite(Benchmark& benchmark)
+	{
+		//the per frame cost of a play snapshot, without its sync: serialize and checksum N particles
+		for (std::size_t size : benchmark.getSizes()) {
+			ParticleSystem particleSystem;
+			particleSystem.reserve(size);
+			for (std::size_t i = 0; i < size; i++) {
+				particleSystem.addParticle();
+			}
+			particleSystem.rebirthAll();
+
+			std::vector<unsigned char> data(particleSystem.getSnapshotSize());
+			volatile std::uint32_t sink = 0;
+			benchmark.run("snapshot.write", size, [&]() {
+				particleSystem.writeSnapshot(data.data());
+				sink = MathModule::getChecksum(data.data(), data.size());
+			});
+		}
+	}
+
+	void benchTimerWheel(Benchmark& benchmark)
+	{
+		//N timers spread over 2 seconds, scheduled, then fired by 60 Hz steps, on a wheel whose pool is warm (as in a play):
+		for (std::size_t size : benchmark.getSizes()) {
+			std::vector<float> times(size);
+			MathModule::fillRandom(times.data(), size, 0, 2);
+			std::size_t fired = 0;
+			std::size_t* firedPtr = &fired;
+			TimerWheel timers;
+
+			benchmark.run("timers.fire", size, [&]() {
+				timers.reset(0);
+				for (std::size_t i = 0; i < size; i++) {
+					timers.schedule(times[i], Delegate<void()>::fromFunctor([firedPtr]() { (*firedPtr)++; }));
+				}
+				for (int step = 1; timers.getPendingCount() > 0; step++) {
+					timers.advance(step / 60.0);
+				}
+			});
+		}
+	}
+
+	void benchGeneratePolygon(Benchmark& benchmark)
+	{
+		//PolyParticleShape construction, dominated by generatePolygon() for many points:
+		boost::shared_ptr<ParticleSystem> particleSystem(new ParticleSystem);
+		for (std::size_t size : benchmark.getSizes()) {
+			benchmark.run("polygon.generate", size, [&]() {
+				PolyParticleShape particle(particleSystem, { 400, 300 }, int(size), 20, sf::Color::White);
+			});
+		}
+	}
+
+	void benchGetRandom(Benchmark& benchmark)
+	{
+		volatile float sink = 0;
+		for (std::size_t size : benchmark.getSizes()) {
+			benchmark.run("random.getRandom", size, [&]() {
+				float sum = 0;
+				for (std::size_t i = 0; i < size; i++) {
+					sum += MathModule::getRandom(0, 1);
+				}
+				sink = sum;
+			});
+		}
+	}
+
+	void benchFillRandom(Benchmark& benchmark)
+	{
+		for (std::size_t size : benchmark.getSizes()) {
+			std::vector<float> values(size);
+			benchmark.run("random.fillRandom", size, [&]() {
+				MathModule::fillRandom(values.data(), size, 0, 1);
+			});
+		}
+	}
+
+	void benchJournalAppend(Benchmark& benchmark, const std::string& path)
+	{
+		//a burst of N events, until durable, group committed and compacted as in the game:
+		for (std::size_t size : benchmark.getSizes(100000)) {
+			removeJournal(path);
+			CreditJournal journal(path);
+			benchmark.run("journal.append", size, [&]() {
+				for (std::size_t i = 0; i < size; i++) {
+					journal.append(CreditJournal::CreditInserted);
+				}
+				journal.flush();
+			});
+		}
+		removeJournal(path);
+	}
+
+	void benchJournalRecover(Benchmark& benchmark, const std::string& path)
+	{
+		//startup against a journal of N records, never compacted:
+		for (std::size_t size : benchmark.getSizes()) {
+			removeJournal(path);
+			{
+				CreditJournal journal(path, 0);
+				for (std::size_t i = 0; i < size; i++) {
+					journal.append(CreditJournal::CreditInserted);
+				}
+			}
+			benchmark.run("journal.recover", size, [&]() {
+				CreditJournal journal(path, 0);
+			});
+		}
+		removeJournal(path);
+	}
+
+	void benchButtonDispatch(Benchmark& benchmark, bool useGrid)
+	{
+		//a mouse moving across the area, over N buttons laid out on a lobby sized grid (the events carry their coordinates):
+		sf::Event evnt;
+		evnt.type = sf::Event::MouseMoved;
+		const sf::Vector2u lobbySize(3200, 2400);
+
+		for (std::size_t size : benchmark.getSizes(100000)) {
+			std::vector<boost::shared_ptr<ButtonInterface>> buttons;
+			HitTestGrid hitTestGrid({ float(lobbySize.x), float(lobbySize.y) });
+			for (std::size_t i = 0; i < size; i++) {
+				sf::Vector2f position(float(i % 64) * 50, float(i / 64 % 48) * 50);
+				buttons.push_back(boost::shared_ptr<ButtonInterface>(
+					new ButtonShape("B", position, { 40, 40 }, sf::Color::Green, sf::Color::White)));
+				hitTestGrid.add(buttons.back());
+			}
+
+			std::size_t iteration = 0;
+			benchmark.run(useGrid ? "buttons.hitGrid" : "buttons.dispatch", size, [&]() {
+				evnt.mouseMove.x = int(iteration * 7 % lobbySize.x);
+				evnt.mouseMove.y = int(iteration * 13 % lobbySize.y);
+				iteration++;
+				if (useGrid) {
+					hitTestGrid.dispatch(nullptr, evnt);
+				}
+				else {
+					//same dispatch as CasinoGame::updateButtonsOnWindowEvent was, every button tests every event:
+					for (const boost::shared_ptr<ButtonInterface>& button : buttons) {
+						button->onWindowEvent(nullptr, evnt);
+					}
+				}
+			});
+		}
+	}
+
+	void benchTextReset(Benchmark& benchmark)
+	{
+		TextShape text("0", { 400, 300 }, { 100, 40 }, 25);
+		for (std::size_t size : benchmark.getSizes()) {
+			//alternate between two contents, so that every iteration changes the text:
+			std::string contents[2] = { std::string(size, '0'), std::string(size, '1') };
+			std::size_t iteration = 0;
+			benchmark.run("text.resetContent", size, [&]() {
+				text.resetContent(contents[iteration++ % 2]);
+			});
+		}
+	}
+
+	void addDrawChildren(RenderQueue& renderQueue, std::vector<std::pair<boost::shared_ptr<WindowInterface>, int>>& children,
+		std::size_t size)
+	{
+		//static (l1) and dynamic (l4) boxes, with their two textures interleaved in order of addition:
+		const char* textures[2] = { "MyResources/Textures/woodPallet.png", "MyResources/Textures/halfWoodPallet.png" };
+		for (std::size_t i = 0; i < size; i++) {
+			sf::Vector2f position(float(i % 16) * 50, float(i / 16 % 12) * 50);
+			boost::shared_ptr<WindowInterface> child(new BoxShape(position, { 40, 40 }, textures[i % 2]));
+			int layer = i / 2 % 2 == 0 ? WindowModel::l1 : WindowModel::l4;
+			children.push_back({ child, layer });
+			renderQueue.add(child, layer);
+		}
+	}
+
+	void benchDrawChildren(Benchmark& benchmark)
+	{
+		sf::RenderTexture target;
+		target.create(areaSize.x, areaSize.y);
+
+		//as WindowModel::drawChildren without the layer cache, every layer through the render queue, to an offscreen target:
+		for (std::size_t size : benchmark.getSizes(100000)) {
+			RenderQueue renderQueue;
+			std::vector<std::pair<boost::shared_ptr<WindowInterface>, int>> children;
+			addDrawChildren(renderQueue, children, size);
+
+			benchmark.run("draw.children", size, [&]() {
+				renderQueue.beginFrame();
+				target.clear();
+				renderQueue.draw(&target, WindowModel::l0, WindowModel::l5);
+				target.display();
+			});
+		}
+	}
+
+	void benchDrawLayerCache(Benchmark& benchmark)
+	{
+		sf::RenderTexture target;
+		target.create(areaSize.x, areaSize.y);
+		sf::RenderTexture layerCache;
+		layerCache.create(areaSize.x, areaSize.y);
+		sf::Sprite layerCacheSprite(layerCache.getTexture());
+
+		//as WindowModel::drawChildren with the layer cache: the static layers redrawn only when one of their children changed,
+		//none does here, then copied as one sprite under the dynamic layers:
+		for (std::size_t size : benchmark.getSizes(100000)) {
+			RenderQueue renderQueue;
+			std::vector<std::pair<boost::shared_ptr<WindowInterface>, int>> children;
+			addDrawChildren(renderQueue, children, size);
+			bool cacheInvalid = true;
+
+			benchmark.run("draw.layerCache", size, [&]() {
+				renderQueue.beginFrame();
+				bool dirty = cacheInvalid;
+				for (std::pair<boost::shared_ptr<WindowInterface>, int>& child : children) {
+					if (child.second <= WindowModel::l2 && child.first->takeDirty()) {
+						dirty = true;
+					}
+				}
+				if (dirty) {
+					layerCache.clear();
+					renderQueue.draw(&layerCache, WindowModel::l0, WindowModel::l2);
+					layerCache.display();
+					cacheInvalid = false;
+				}
+
+				target.clear();
+				target.draw(layerCacheSprite, sf::RenderStates(sf::BlendNone));
+				renderQueue.recordDraw(&target, &layerCache.getTexture());
+				renderQueue.draw(&target, WindowModel::l3, WindowModel::l5);
+				target.display();
+			});
+		}
+	}
+
+	void benchDrawParticleBatch(Benchmark& benchmark)
+	{
+		sf::RenderTexture target;
+		target.create(areaSize.x, areaSize.y);
+
+		for (std::size_t size : benchmark.getSizes(100000)) {
+			boost::shared_ptr<ParticleSystem> particleSystem(new ParticleSystem);
+			std::vector<boost::shared_ptr<PolyParticleShape>> particles;
+			ParticleBatch particleBatch;
+			for (std::size_t i = 0; i < size; i++) {
+				particles.push_back(boost::shared_ptr<PolyParticleShape>(
+					new PolyParticleShape(particleSystem, { 400, 300 }, 10, 20, sf::Color::White)));
+				particles.back()->setTexture("MyResources/Textures/gold.jpg");
+				particleBatch.addParticle(*particles.back());
+			}
+			PolyParticleShape::setupRandomBirthStates(particles, sf::Vector2f(areaSize));
+			particleSystem->rebirthAll();
+			particleSystem->update(1.0f);
+
+			ParticleSystem::Frame frame;
+			particleSystem->copyFrame(frame);
+			particleBatch.setFrame(&frame, 1);
+
+			benchmark.run("draw.particleBatch", size, [&]() {
+				target.clear();
+				particleBatch.drawTo(&target);
+				target.display();
+			});
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	Benchmark::Options options;
+	std::string format = "csv";
+	std::string journalPath = "ACasinoGameBenchCredits";
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--max" && i + 1 < argc) {
+			options.maxSize = std::stoul(argv[++i]);
+		}
+		else if (arg == "--min-samples" && i + 1 < argc) {
+			options.minSamples = std::stoul(argv[++i]);
+		}
+		else if (arg == "--min-time" && i + 1 < argc) {
+			options.minTime = std::stod(argv[++i]);
+		}
+		else if (arg == "--filter" && i + 1 < argc) {
+			options.filter = argv[++i];
+		}
+		else if (arg == "--format" && i + 1 < argc) {
+			format = argv[++i];
+		}
+		else if (arg == "--journal" && i + 1 < argc) {
+			journalPath = argv[++i];
+		}
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--max N] [--min-samples N] [--min-time S] [--filter NAME] [--format csv|json] [--journal PATH]\n";
+			return 1;
+		}
+	}
+
+	//same random sequences on every run:
+	MathModule::setRandomSeed(1);
+
+	Benchmark benchmark(options);
+	if (benchmark.isEnabled("particles.update")) {
+		benchParticleUpdate(benchmark, "particles.update", ParticleSystem::Euler);
+	}
+	if (benchmark.isEnabled("particles.analytic")) {
+		benchParticleUpdate(benchmark, "particles.analytic", ParticleSystem::Analytic);
+	}
+	if (benchmark.isEnabled("snapshot.write")) {
+		benchSnapshotWrite(benchmark);
+	}
+	if (benchmark.isEnabled("timers.fire")) {
+		benchTimerWheel(benchmark);
+	}
+	if (benchmark.isEnabled("polygon.generate")) {
+		benchGeneratePolygon(benchmark);
+	}
+	if (benchmark.isEnabled("random.getRandom")) {
+		benchGetRandom(benchmark);
+	}
+	if (benchmark.isEnabled("random.fillRandom")) {
+		benchFillRandom(benchmark);
+	}
+	if (benchmark.isEnabled("text.resetContent")) {
+		benchTextReset(benchmark);
+	}
+	if (benchmark.isEnabled("draw.children")) {
+		benchDrawChildren(benchmark);
+	}
+	if (benchmark.isEnabled("draw.layerCache")) {
+		benchDrawLayerCache(benchmark);
+	}
+	if (benchmark.isEnabled("draw.particleBatch")) {
+		benchDrawParticleBatch(benchmark);
+	}
+	if (benchmark.isEnabled("journal.append")) {
+		benchJournalAppend(benchmark, journalPath);
+	}
+	if (benchmark.isEnabled("journal.recover")) {
+		benchJournalRecover(benchmark, journalPath);
+	}
+
+	if (benchmark.isEnabled("buttons.dispatch")) {
+		benchButtonDispatch(benchmark, false);
+	}
+	if (benchmark.isEnabled("buttons.hitGrid")) {
+		benchButtonDispatch(benchmark, true);
+	}
+
+	if (format == "json") {
+		benchmark.writeJSON(std::cout);
+	}
+	else {
+		benchmark.writeCSV(std::cout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*****************************************************************
+ * \file	Benchmark.cpp
+ * \brief	Functions and methods for class Benchmark, to be used with Benchmark.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+	std::atomic<std::size_t> allocationCount(0);
+}
+
+//count every heap allocation of the benchmark executable:
+void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* pointer = std::malloc(size == 0 ? 1 : size);
+	if (pointer == nullptr) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+Benchmark::Benchmark(const Options& options) :
+	m_options(options)
+{
+}
+
+std::vector<std::size_t> Benchmark::getSizes(std::size_t maxSize) const
+{
+	std::vector<std::size_t> sizes;
+	for (std::size_t size = 10; size <= m_options.maxSize && size <= maxSize; size *= 10) {
+		sizes.push_back(size);
+	}
+	return sizes;
+}
+
+bool Benchmark::isEnabled(const std::string& name) const
+{
+	return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+}
+
+const std::vector<Benchmark::Result>& Benchmark::getResults() const
+{
+	return m_results;
+}
+
+void Benchmark::writeCSV(std::ostream& stream) const
+{
+	stream << "benchmark,size,samples,median_ns,p99_ns,median_ns_per_item,allocations_per_iteration\n";
+	for (const Result& result : m_results) {
+		stream << result.name << ',' << result.size << ',' << result.samples << ','
+			<< result.medianTime << ',' << result.p99Time << ',' << result.medianTime / result.size << ','
+			<< result.allocationsPerIteration << '\n';
+	}
+}
+
+void Benchmark::writeJSON(std::ostream& stream) const
+{
+	stream << "[\n";
+	for (std::size_t i = 0; i < m_results.size(); i++) {
+		const Result& result = m_results[i];
+		stream << "  {\"benchmark\": \"" << result.name << "\", \"size\": " << result.size
+			<< ", \"samples\": " << result.samples
+			<< ", \"median_ns\": " << result.medianTime << ", \"p99_ns\": " << result.p99Time
+			<< ", \"median_ns_per_item\": " << result.medianTime / result.size
+			<< ", \"allocations_per_iteration\": " << result.allocationsPerIteration << "}"
+			<< (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	stream << "]\n";
+}
+
+std::size_t Benchmark::getAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+void Benchmark::addResult(const std::string& name, std::size_t size, std::vector<double>& times, std::size_t allocations)
+{
+	std::sort(times.begin(), times.end());
+
+	Result result;
+	result.name = name;
+	result.size = size;
+	result.samples = times.size();
+	if (!times.empty()) {
+		//nearest rank percentiles:
+		result.medianTime = times[(times.size() - 1) / 2];
+		result.p99Time = times[std::min(times.size() - 1, (times.size() * 99 + 99) / 100 - 1)];
+		result.allocationsPerIteration = double(allocations) / times.size();
+	}
+	m_results.push_back(result);
+
+	std::cerr << name << " [" << size << "]: " << result.medianTime << " ns median, "
+		<< result.p99Time << " ns p99, " << result.allocationsPerIteration << " allocations\n";
+}
@@ -0,0 +1,156 @@
+/*****************************************************************
+ * \file	Benchmark.hpp
+ * \brief	Header is for class Benchmark, to be used with Benchmark.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark class times the iterations of a piece of code, for a sweep of problem sizes,
+ * and reports the median and 99th percentile time per iteration, and the heap allocations per iteration
+ * (every operator new of the benchmark executable is counted).
+ */
+class Benchmark
+{
+public:
+	/**
+	 * @brief Structure which holds the options of the benchmark runs.
+	 */
+	struct Options {
+		/** @brief Holds the largest problem size of the sweep. */
+		std::size_t maxSize = 1000000;
+		/** @brief Holds the minimum number of timed iterations per size. */
+		std::size_t minSamples = 10;
+		/** @brief Holds the maximum number of timed iterations per size. */
+		std::size_t maxSamples = 1000;
+		/** @brief Holds the minimum time spent timing each size, in seconds. */
+		double minTime = 0.05;
+		/** @brief Holds the filter, only the benchmarks whose name contains it run. */
+		std::string filter;
+	};
+
+	/**
+	 * @brief Structure which holds the result of a benchmark, for one size.
+	 */
+	struct Result {
+		/** @brief Holds the name of the benchmark. */
+		std::string name;
+		/** @brief Holds the problem size. */
+		std::size_t size = 0;
+		/** @brief Holds the number of timed iterations. */
+		std::size_t samples = 0;
+		/** @brief Holds the median time per iteration, in nanoseconds. */
+		double medianTime = 0;
+		/** @brief Holds the 99th percentile time per iteration, in nanoseconds. */
+		double p99Time = 0;
+		/** @brief Holds the mean number of heap allocations per iteration. */
+		double allocationsPerIteration = 0;
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param options The options of the runs.
+	 */
+	Benchmark(const Options& options);
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~Benchmark() = default;
+
+	/**
+	 * @brief Method which gets the sizes of the sweep: powers of 10, from 10 to the smallest of maxSize and the options maximum.
+	 * @param maxSize The largest size the benchmark supports.
+	 * @return The sizes.
+	 */
+	std::vector<std::size_t> getSizes(std::size_t maxSize = ~std::size_t(0)) const;
+
+	/**
+	 * @brief Method which checks if a benchmark passes the filter.
+	 * @param name The name of the benchmark.
+	 * @return The value of true if it is to run.
+	 */
+	bool isEnabled(const std::string& name) const;
+
+	/**
+	 * @brief Method which times the iterations of a benchmark, for one size, and keeps the result.
+	 * @param name The name of the benchmark.
+	 * @param size The problem size.
+	 * @param iteration The code to be timed, called once per iteration.
+	 */
+	template <typename Iteration>
+	void run(const std::string& name, std::size_t size, Iteration iteration)
+	{
+		std::vector<double> times;
+		std::size_t allocations = 0;
+
+		Clock::time_point start = Clock::now();
+		while (times.size() < m_options.maxSamples &&
+			(times.size() < m_options.minSamples || std::chrono::duration<double>(Clock::now() - start).count() < m_options.minTime)) {
+			std::size_t allocationsBefore = getAllocationCount();
+			Clock::time_point iterationStart = Clock::now();
+
+			iteration();
+
+			Clock::time_point iterationEnd = Clock::now();
+			allocations += getAllocationCount() - allocationsBefore;
+			times.push_back(std::chrono::duration<double, std::nano>(iterationEnd - iterationStart).count());
+		}
+
+		addResult(name, size, times, allocations);
+	}
+
+	/**
+	 * @brief Method which gets the results of every run.
+	 * @return The results.
+	 */
+	const std::vector<Result>& getResults() const;
+
+	/**
+	 * @brief Method which writes the results as CSV, one line per benchmark and size.
+	 * @param stream The output stream.
+	 */
+	void writeCSV(std::ostream& stream) const;
+
+	/**
+	 * @brief Method which writes the results as a JSON array, one object per benchmark and size.
+	 * @param stream The output stream.
+	 */
+	void writeJSON(std::ostream& stream) const;
+
+	/**
+	 * @brief Static method which gets the number of heap allocations since the start of the executable.
+	 * @return The number of allocations.
+	 */
+	static std::size_t getAllocationCount();
+
+private:
+	/**
+	 * @brief Type of the clock the iterations are timed with.
+	 */
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * @brief Method which computes the statistics of a run and keeps its result.
+	 * @param name The name of the benchmark.
+	 * @param size The problem size.
+	 * @param times The time of each iteration, in nanoseconds.
+	 * @param allocations The number of allocations of every iteration.
+	 */
+	void addResult(const std::string& name, std::size_t size, std::vector<double>& times, std::size_t allocations);
+
+	/** @brief Holds the options of the runs. */
+	Options m_options;
+
+	/** @brief Holds the results of every run. */
+	std::vector<Result> m_results;
+};
@@ -86,9 +86,17 @@ public:
 
 	/**
 	 * @brief Method which draws the rectangle shape to a specific window.
-	 * @param window The window object reference.
+	 * @param target The render target, a window or an offscreen texture.
 	 */
-	virtual void drawTo(sf::RenderWindow* window) override;
+	virtual void drawTo(sf::RenderTarget* target) override;
+
+	/**
+	 * @brief Method which gets the texture a draw pass uses.
+	 * @param pass The draw pass, the rectangle.
+	 * @return The texture of the rectangle, nullptr if none.
+	 * @see WindowInterface
+	 */
+	virtual const sf::Texture* getDrawPassTexture(std::size_t pass) const override;
 
 	/**
 	 * @brief Method which rotates the rectangle shape.
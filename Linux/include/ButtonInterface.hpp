@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Window/Event.hpp>
-#include <map>
+
+#include "Delegate.hpp"
 
 namespace sf {
 	class RenderWindow;
@@ -17,14 +19,14 @@ namespace sf {
 
 /**
  * @brief ButtonInterface class used to interface buttons to be rendered on a window
- * and enables reactions to window events, with non parameter specific callbacks funtions.
+ * and enables reactions to window events, with typed (allocation free) callbacks.
  */
 class ButtonInterface
 {
 public:
 
 	/**
-	 * @brief Constructor, sets the args map to nullptr.
+	 * @brief Constructor, sets an empty click callback.
 	 */
 	ButtonInterface();
 
@@ -40,25 +42,25 @@ public:
 	 */
 	virtual void onWindowEvent(sf::RenderWindow* window, const sf::Event& evnt) = 0;
 
+	/**
+	 * @brief Method which gets the area the button reacts to the mouse in, so that the mouse events are only sent to
+	 * the buttons under them (and to the ones the mouse leaves).
+	 * @return The bounds, in window coordinates.
+	 */
+	virtual sf::FloatRect getHitBounds() const = 0;
+
 	/**
 	 * @brief Method which sets the click callback, in case it's called inside onWindowEvent.
-	 * @param callback A function pointer.
-	 * @param argsMap The function's arguments map.
+	 * @param callback The callback, with its bound context.
 	 * @see onWindowEvent()
 	 */
-	virtual void setClickCallback(void (*callback)(std::map<std::string, void*>), const std::map<std::string, void*>& argsMap);
+	virtual void setClickCallback(const Delegate<void()>& callback);
 
 protected:
 
 	/**
-	 * @brief Holds the callback function to be called when setClickCallback is evoked.
-	 * @see setClickCallback()
-	 */
-	void (*p_clickCallback)(std::map<std::string, void*>);
-
-	/**
-	 * @brief Holds the parameters of the callback function to be called when setClickCallback is evoked.
+	 * @brief Holds the callback to be called when the button is clicked.
 	 * @see setClickCallback()
 	 */
-	std::map<std::string, void*> p_clickCallbackArgsMap;
+	Delegate<void()> p_clickCallback;
 };
\ No newline at end of file
@@ -12,7 +12,7 @@
 #include "ButtonInterface.hpp"
 #include <boost/shared_ptr.hpp>
 
-class CustomSound;
+class SoundEffect;
 
 /**
  * @brief ButtonShape class used to handle button common behaviours
@@ -60,12 +60,20 @@ public:
 	 */
 	bool isMouseOver(sf::RenderWindow* window);
 
+	/**
+	 * @brief Method which checks if a mouse position is over the current object rectagle area, and updates the hover state,
+	 * warning: this function assumes the object isn't rotated.
+	 * @param mousePosition The mouse position, in window coordinates.
+	 * @return The value of true if the position is over the button.
+	 */
+	bool isMouseOver(const sf::Vector2i& mousePosition);
+
 	/**
 	 * @brief Method which draws the button object,and its compositors to the window.
-	 * @param window The window object reference.
+	 * @param target The render target, a window or an offscreen texture.
 	 * @see WindowInterface
 	 */
-	virtual void drawTo(sf::RenderWindow* window) override;
+	virtual void drawTo(sf::RenderTarget* target) override;
 
 	/**
 	 * @brief Method which gets the current internal state of the button.
@@ -87,6 +95,14 @@ public:
 	 */
 	virtual void onWindowEvent(sf::RenderWindow* window, const sf::Event& evnt) override;
 
+	/**
+	 * @brief Method which gets the area the button reacts to the mouse in, its rectangle,
+	 * warning: this function assumes the object isn't rotated.
+	 * @return The bounds, in window coordinates.
+	 * @see ButtonInterface
+	 */
+	virtual sf::FloatRect getHitBounds() const override;
+
 	/**
 	 * @brief Method which sets and loads the hover behaviour sound.
 	 * @param path The path of the sound to be played.
@@ -124,11 +140,11 @@ private:
 	/** @brief Holds the flag value, true if the button state was toggled. */
 	bool m_toggled;
 
-	/** @brief Holds the CustomSound reference for the hover sound, if it is allocated. */
-	boost::shared_ptr<CustomSound> m_hoverSound;
+	/** @brief Holds the SoundEffect reference for the hover sound, if it is allocated. */
+	boost::shared_ptr<SoundEffect> m_hoverSound;
 
-	/** @brief Holds the CustomSound reference for the click sound, if it is allocated. */
-	boost::shared_ptr<CustomSound> m_clickSound;
+	/** @brief Holds the SoundEffect reference for the click sound, if it is allocated. */
+	boost::shared_ptr<SoundEffect> m_clickSound;
 
 	/** @brief Holds the flag value, true if the hover sound is active. */
 	bool m_hoverSoundActive;
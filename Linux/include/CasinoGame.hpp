@@ -8,8 +8,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Window/Event.hpp>
@@ -17,15 +24,27 @@
 #include <boost/shared_ptr.hpp>
 
 #include "CustomSound.hpp"
+#include "ParticleSystem.hpp"
+#include "ThreadTimer.hpp"
+#include "TripleBuffer.hpp"
 
 class WindowModel;
 class WindowInterface;
 class ButtonInterface;
+class ButtonShape;
+class TextShape;
 class ParticleInterface;
+class ParticleBatch;
+class CreditJournal;
+class SnapshotFile;
+class HitTestGrid;
 
 /**
  * @brief CasinoGame class used to run and handle all the variables necessary
  * to run a casino game object, from initialization to communication between objects on window evets.
+ * The simulation (game state and particle physics) and the views are split: the views issue commands to the simulation,
+ * and the simulation publishes snapshots of its state, which the views are synchronized with.
+ * So the simulation may run on its own thread, see startSimulationThread().
  */
 class CasinoGame
 {
@@ -80,6 +99,33 @@ public:
 		}
 	};
 
+	/**
+	 * @brief Type which identifies a command issued by the views to the simulation.
+	 */
+	enum Command {
+		Start,
+		CreditsIn,
+		CreditsOut
+	};
+
+	/**
+	 * @brief Structure which holds an immutable copy of the simulation, published after every physics step.
+	 */
+	struct Snapshot {
+		/** @brief Holds the game state. */
+		State state;
+		/** @brief Holds the render state of the particles. */
+		ParticleSystem::Frame particles;
+		/** @brief Holds the number of times each particle was born, since the game started. */
+		std::vector<unsigned int> birthEvents;
+		/** @brief Holds the number of times each particle died, since the game started. */
+		std::vector<unsigned int> deathEvents;
+		/** @brief Holds the time the snapshot was published. */
+		std::chrono::steady_clock::time_point publishTime;
+		/** @brief Holds the time interval of the physics step which produced the snapshot. */
+		float stepTime = 0;
+	};
+
 	/**
 	 * @brief Constructor.
 	 * @param windowModel The window model to run the game on.
@@ -87,9 +133,47 @@ public:
 	CasinoGame(boost::shared_ptr<WindowModel> windowModel);
 
 	/**
-	 * @brief Default destructor.
+	 * @brief Constructor, of a headless game: only the simulation runs, without window, views, textures nor sounds.
+	 * Commands are to be issued with issueCommand(), and the physics stepped with updatePhysics().
+	 * @param areaSize The size of the simulated area, as if it was a window.
+	 */
+	CasinoGame(const sf::Vector2u& areaSize);
+
+	/**
+	 * @brief Destructor, stops the simulation thread, if it is running.
+	 */
+	~CasinoGame();
+
+	/**
+	 * @brief Method which opens the credit journal the game state is persisted to, and loaded from by init().
+	 * To be called before init(), without it the game starts from an empty state every time.
+	 * @param path The path of the journal files, without extension.
+	 * @see CreditJournal
 	 */
-	~CasinoGame() = default;
+	void openCreditJournal(const std::string& path);
+
+	/**
+	 * @brief Method which sets the file the play is snapshotted to on every physics step, and restored from by init(),
+	 * so that a play interrupted by a power loss resumes where it was. To be called before init().
+	 * @param path The path of the snapshot file.
+	 * @see SnapshotFile
+	 */
+	void openPlaySnapshots(const std::string& path);
+
+	/**
+	 * @brief Method which sets how the particles move, Euler by default. With Analytic, their trajectories are evaluated
+	 * in closed form, and their death times predicted from the left side of the area.
+	 * @param kinematics The kinematics.
+	 * @see ParticleSystem::Kinematics
+	 */
+	void setKinematics(ParticleSystem::Kinematics kinematics);
+
+	/**
+	 * @brief Method which sets the counters the game starts from, without a credit journal (e.g. a replayed session).
+	 * To be called before init().
+	 * @param state The game state, only its counters are used.
+	 */
+	void setInitialState(const State& state);
 
 	/**
 	 * @brief Method which runs all the necessary initialization functions to instatiate the game.
@@ -105,30 +189,130 @@ public:
 	void switchToWindow(boost::shared_ptr<WindowModel> windowModel);
 
 	/**
-	 * @brief Method which, when called, updates the buttons according to an event.
+	 * @brief Method which, when called, updates the buttons according to an event, through the hit test grid:
+	 * mouse events only reach the buttons under them, and the ones the mouse leaves.
 	 * @param evnt The window event.
 	 * @see WindowInterface
 	 */
 	void updateButtonsOnWindowEvent(const sf::Event& evnt);
 
 	/**
-	 * @brief Method which updates the physics of the internal particles on \pm_particleMap
-	 * based on deltaTime.
+	 * @brief Method which issues a command to the simulation, applied on its next physics step. It may be called from any thread.
+	 * @param command The command.
+	 */
+	void issueCommand(Command command);
+
+	/**
+	 * @brief Method which applies the commands issued, updates the physics of the internal particles on \pm_particleSystem
+	 * based on deltaTime, and publishes a snapshot. It is not to be called while the simulation thread is running.
 	 * @param deltaTime The time interval to update the differential equations.
 	 */
 	void updatePhysics(float deltaTime);
 
 	/**
-	 * @brief Method which gives access to the window running the game (not the owner).
+	 * @brief Method which sets how far the rendered particles are between the last two physics steps,
+	 * used when the simulation isn't threaded.
+	 * @param alpha The fraction of a step, accumulated but not yet simulated.
+	 */
+	void setInterpolationAlpha(float alpha);
+
+	/**
+	 * @brief Method which synchronizes the views (texts, buttons, particle sounds and positions) with the latest snapshot
+	 * published by the simulation. To be called by the render thread, before drawing.
+	 */
+	void syncViews();
+
+	/**
+	 * @brief Method which starts running the physics on a dedicated thread, in fixed steps.
+	 * @param stepTime The fixed physics step, in seconds.
+	 */
+	void startSimulationThread(float stepTime);
+
+	/**
+	 * @brief Method which stops the simulation thread, if it is running, and waits for it.
+	 */
+	void stopSimulationThread();
+
+	/**
+	 * @brief Method which gets the timing statistics of the physics steps, on whichever thread they run.
+	 * @return The statistics, one iteration per physics step.
+	 */
+	ThreadTimer::Stats getSimulationTimerStats() const;
+
+	/**
+	 * @brief Method which gets the current game state, on the simulation side.
+	 * It is not to be called while the simulation thread is running.
+	 * @return The game state.
+	 */
+	const State& getState() const;
+
+	/**
+	 * @brief Method which computes a checksum of the simulation, game state and particles, to compare two runs.
+	 * It is not to be called while the simulation thread is running.
+	 * @return The CRC-32 of the simulation.
+	 */
+	std::uint32_t getSimulationChecksum() const;
+
+	/**
+	 * @brief Method which gives access to the credit journal, nullptr if it isn't open.
+	 * @return The credit journal.
+	 */
+	boost::shared_ptr<CreditJournal> getCreditJournal() const;
+
+	/**
+	 * @brief Method which gives access to the play snapshot file, nullptr if it isn't open.
+	 * @return The play snapshot file.
+	 */
+	boost::shared_ptr<SnapshotFile> getPlaySnapshots() const;
+
+	/**
+	 * @brief Method which gives access to the hit test grid the window events are dispatched through, nullptr if headless.
+	 * @return The hit test grid.
+	 */
+	boost::shared_ptr<HitTestGrid> getHitTestGrid() const;
+
+	/**
+	 * @brief Method which checks if the game runs without window.
+	 * @return The value of true if the game is headless.
+	 */
+	bool isHeadless() const;
+
+	/**
+	 * @brief Method which gives access to the window running the game (not the owner), nullptr if headless.
 	 */
 	WindowModel* getCurrentWindow();
 
 private:
 	/**
-	 * @brief Method which loads a game state.
+	 * @brief Method which loads a game state, from the credit journal if it is open.
 	 */
 	void loadState();
 
+	/**
+	 * @brief Method which appends a credit event to the credit journal, if it is open, on the simulation side.
+	 * @param event The event, a CreditJournal::Event.
+	 */
+	void journalEvent(unsigned int event);
+
+	/**
+	 * @brief Method which opens the play snapshot file, and restores the play it holds, if it is still ongoing:
+	 * the particles, the random engine and the play flags. The credit counters come from the credit journal, if it is open,
+	 * and the snapshot is ignored unless its counters all match the journal.
+	 */
+	void restorePlay();
+
+	/**
+	 * @brief Method which snapshots the play (game state, random engine and particles) to the play snapshot file,
+	 * if it is open, on the simulation side: every step while a play is in flight, between plays only when the state changes.
+	 */
+	void savePlay();
+
+	/**
+	 * @brief Method which gets the number of bytes of a play snapshot.
+	 * @return The number of bytes.
+	 */
+	std::size_t getPlaySnapshotSize() const;
+
 	/**
 	 * @brief Method which initializes the game environment music.
 	 */
@@ -175,24 +359,42 @@ private:
 	void addShapesToWindow();
 
 	/**
-	 * @brief Static method, to be used as a callback function pointer, which handles a start button click event.
+	 * @brief Method which resolves the views that are synchronized with the snapshots, and publishes the initial one.
 	 */
-	static void onStartButton(std::map<std::string, void*> argsMap);
+	void connectViews();
 
 	/**
-	 * @brief Static method, to be used as a callback function pointer, which handles a credits inserted button click event.
+	 * @brief Method which applies a command to the game state, on the simulation side.
+	 * Start starts, pauses or resumes a play, CreditsIn inserts a credit, CreditsOut removes a credit.
+	 * @param command The command.
 	 */
-	static void onCreditsInButton(std::map<std::string, void*> argsMap);
+	void applyCommand(Command command);
 
 	/**
-	 * @brief Static method, to be used as a callback function pointer, which handles a credits removed button click event.
+	 * @brief Static method, bound as the ParticleSystem death condition, which kills the particles that left the window by the left side.
+	 * @param particleSystem The particle system.
+	 * @param index The index of the particle to be checked.
+	 * @return The value of true if the particle is to be killed.
 	 */
-	static void onCreditsOutButton(std::map<std::string, void*> argsMap);
+	static bool particleDeathCondition(const ParticleSystem& particleSystem, ParticleSystem::Index index);
 
 	/**
-	 * @brief Static method, to be used as a callback function pointer, which handles a particle death verification event.
+	 * @brief Method which handles the end of a play
+	 * (raised once by the ParticleSystem, when its last alive particle dies).
 	 */
-	static bool particleDeathCondition(std::map<std::string, void*> argsMap);
+	void onAllParticlesDead();
+
+	/**
+	 * @brief Method which copies the simulation into a snapshot and publishes it.
+	 * @param stepTime The time interval of the last physics step.
+	 */
+	void publishSnapshot(float stepTime);
+
+	/**
+	 * @brief Method which runs the physics in fixed steps, until \pm_simulationRunning is cleared, on the simulation thread.
+	 * @param stepTime The fixed physics step, in seconds.
+	 */
+	void simulationLoop(float stepTime);
 
 	/** @brief Holds the \pm_currentWindow size */
 	sf::Vector2f m_winSize;
@@ -203,15 +405,99 @@ private:
 	/** @brief Holds the map of ButtonInterface references, one for each allocated button (is the owner). */
 	std::map<std::string, boost::shared_ptr<ButtonInterface>> m_buttonMap;
 
-	/** @brief Holds the map of ParticleInterface references, one for each allocated particle (is the owner). */
-	std::map<std::string, boost::shared_ptr<ParticleInterface>> m_particleMap;
+	/** @brief Holds the HitTestGrid reference, which dispatches the window events to the buttons of \pm_buttonMap. */
+	boost::shared_ptr<HitTestGrid> m_hitTestGrid;
+
+	/** @brief Holds the ParticleSystem reference, which holds the physical state of every particle. */
+	boost::shared_ptr<ParticleSystem> m_particleSystem;
+
+	/** @brief Holds the vector of ParticleInterface references, indexed as in \pm_particleSystem (is the owner). */
+	std::vector<boost::shared_ptr<ParticleInterface>> m_particles;
+
+	/** @brief Holds the credit journal the game state is persisted to, nullptr if it isn't. */
+	boost::shared_ptr<CreditJournal> m_creditJournal;
+
+	/** @brief Holds the path of the play snapshot file, empty if the play isn't snapshotted. */
+	std::string m_playSnapshotPath;
+
+	/** @brief Holds the play snapshot file, nullptr if the play isn't snapshotted. */
+	boost::shared_ptr<SnapshotFile> m_playSnapshots;
+
+	/** @brief Holds the flag value, true if a restored random engine state waits for the thread running the physics. */
+	bool m_randomStatePending;
+
+	/** @brief Holds the random engine state of a restored play, applied on the next physics step. */
+	std::uint64_t m_restoredRandomState[4];
+
+	/** @brief Holds the flag value, true if a play snapshot was written since the snapshots were opened. */
+	bool m_playSaved;
+
+	/** @brief Holds the counters and flags of the last play snapshot written. */
+	std::uint32_t m_savedPlayCounters[4];
 
 	/** @brief Holds the current window pointer, to where game is supposed to be currently being rendered to. */
 	boost::shared_ptr<WindowModel> m_currentWindow;
 
-	/** @brief Holds the current game state. */
+	/** @brief Holds the current game state, owned by the simulation. */
 	State m_currentState;
 
+	/** @brief Holds the game state started from without a credit journal. */
+	State m_initialState;
+
+	/** @brief Holds the game state the views currently show. */
+	State m_viewState;
+
+	/** @brief Holds the commands issued, not yet applied by the simulation. */
+	std::vector<Command> m_issuedCommands;
+
+	/** @brief Holds the commands being applied by the simulation, swapped with \pm_issuedCommands. */
+	std::vector<Command> m_appliedCommands;
+
+	/** @brief Holds the mutex which guards \pm_issuedCommands. */
+	std::mutex m_commandMutex;
+
+	/** @brief Holds the snapshots, handed from the simulation to the views. */
+	TripleBuffer<Snapshot> m_snapshots;
+
+	/** @brief Holds the number of times each particle was born, on the simulation side. */
+	std::vector<unsigned int> m_birthEvents;
+
+	/** @brief Holds the number of times each particle died, on the simulation side. */
+	std::vector<unsigned int> m_deathEvents;
+
+	/** @brief Holds the births each particle already made a sound for, on the views side. */
+	std::vector<unsigned int> m_seenBirthEvents;
+
+	/** @brief Holds the deaths each particle already made a sound for, on the views side. */
+	std::vector<unsigned int> m_seenDeathEvents;
+
+	/** @brief Holds the interpolation factor set by setInterpolationAlpha(). */
+	float m_interpolationAlpha;
+
+	/** @brief Holds the simulation thread. */
+	std::thread m_simulationThread;
+
+	/** @brief Holds the flag value, true while the simulation thread is running. */
+	std::atomic<bool> m_simulationRunning;
+
+	/** @brief Holds the timing of the physics steps. */
+	ThreadTimer m_simulationTimer;
+
+	/** @brief Holds the play count text (not the owner). */
+	TextShape* m_playCountText;
+
+	/** @brief Holds the credits inserted text (not the owner). */
+	TextShape* m_creditsInsertedText;
+
+	/** @brief Holds the credits removed text (not the owner). */
+	TextShape* m_creditsRemovedText;
+
+	/** @brief Holds the start button (not the owner). */
+	ButtonShape* m_startButton;
+
+	/** @brief Holds the particle batch (not the owner). */
+	ParticleBatch* m_particleBatch;
+
 	/** @brief Holds the map of CustomSound references, one for each allocated particle (is the owner). */
 	std::map<std::string, boost::shared_ptr<CustomSound>> m_soundMap;
 
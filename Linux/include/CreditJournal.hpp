@@ -0,0 +1,214 @@
+/*****************************************************************
+ * \file	CreditJournal.hpp
+ * \brief	Header is for class CreditJournal, to be used with CreditJournal.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief CreditJournal class persists the credit counters of the game as an append-only binary write-ahead journal
+ * of credit events (<path>.journal), each record checksummed, periodically compacted into a snapshot (<path>.snapshot).
+ * Appending only queues the event: a dedicated thread writes and syncs every event queued meanwhile at once (group commit),
+ * so a burst of events costs a single fsync, and never stalls the caller.
+ * On construction, the snapshot is loaded and the journal replayed; a torn record at its end, left by a crash while
+ * it was being written, is truncated.
+ */
+class CreditJournal
+{
+public:
+	/**
+	 * @brief Type which identifies a credit event.
+	 */
+	enum Event : std::uint32_t {
+		CreditInserted = 1,
+		CreditRemoved,
+		PlayStarted,
+		PlayEnded
+	};
+
+	/**
+	 * @brief Structure which holds the credit counters.
+	 */
+	struct Counters {
+		/** @brief Holds the play count. */
+		std::uint32_t playCount = 0;
+		/** @brief Holds the inserted plays count. */
+		std::uint32_t insertCount = 0;
+		/** @brief Holds the removed plays count. */
+		std::uint32_t removeCount = 0;
+	};
+
+	/**
+	 * @brief Structure which holds the statistics of the journal.
+	 */
+	struct Stats {
+		/** @brief Holds the number of events appended since it was opened. */
+		std::size_t appended = 0;
+		/** @brief Holds the number of events made durable since it was opened. */
+		std::size_t committed = 0;
+		/** @brief Holds the number of group commits (one fsync each). */
+		std::size_t commits = 0;
+		/** @brief Holds the number of compactions. */
+		std::size_t compactions = 0;
+		/** @brief Holds the number of journal records replayed when it was opened. */
+		std::size_t replayedRecords = 0;
+		/** @brief Holds the value of true if a torn record was truncated when it was opened. */
+		bool truncatedTail = false;
+		/** @brief Holds the time taken to load the snapshot and replay the journal, in seconds. */
+		double recoveryTime = 0;
+	};
+
+	/**
+	 * @brief Constructor, recovers the counters and starts the commit thread.
+	 * @param path The path of the journal files, without extension.
+	 * @param compactionInterval The number of journal records after which it is compacted, 0 to never compact.
+	 */
+	CreditJournal(const std::string& path, std::size_t compactionInterval = 4096);
+
+	/**
+	 * @brief Destructor, commits the events still queued and stops the commit thread.
+	 */
+	~CreditJournal();
+
+	CreditJournal(const CreditJournal&) = delete;
+	CreditJournal& operator=(const CreditJournal&) = delete;
+
+	/**
+	 * @brief Method which gets the counters recovered when the journal was opened, with every event appended since applied.
+	 * @return The counters.
+	 */
+	Counters getCounters() const;
+
+	/**
+	 * @brief Method which queues an event, to be made durable by the next group commit. It doesn't wait for the disk.
+	 * @param event The event.
+	 */
+	void append(Event event);
+
+	/**
+	 * @brief Method which waits until every event appended so far is durable.
+	 */
+	void flush();
+
+	/**
+	 * @brief Method which requests a compaction, on the commit thread, and waits for it.
+	 */
+	void compact();
+
+	/**
+	 * @brief Method which gets the statistics of the journal.
+	 * @return The statistics.
+	 */
+	Stats getStats() const;
+
+	/**
+	 * @brief Static method which applies an event to the counters.
+	 * @param counters The counters.
+	 * @param event The event.
+	 */
+	static void apply(Counters& counters, Event event);
+
+private:
+	/**
+	 * @brief Structure which holds a journal record, as written on disk (little endian).
+	 */
+	struct Record {
+		/** @brief Holds the sequence number of the event, consecutive from 1. */
+		std::uint64_t sequence;
+		/** @brief Holds the event. */
+		std::uint32_t event;
+		/** @brief Holds the CRC-32 of the sequence and event. */
+		std::uint32_t checksum;
+	};
+
+	/**
+	 * @brief Method which loads the snapshot and replays the journal, truncating a torn tail.
+	 */
+	void recover();
+
+	/**
+	 * @brief Method which writes the durable counters into a new snapshot, atomically, and empties the journal.
+	 * Called on the commit thread.
+	 */
+	void writeSnapshot();
+
+	/**
+	 * @brief Method which writes and syncs the queued records in batches, until the journal is destroyed, on the commit thread.
+	 */
+	void commitLoop();
+
+	/**
+	 * @brief Static method which computes the checksum of a record.
+	 * @param record The record.
+	 * @return The CRC-32 of its sequence and event.
+	 */
+	static std::uint32_t computeChecksum(const Record& record);
+
+	/** @brief Holds the path of the journal file. */
+	std::string m_journalPath;
+
+	/** @brief Holds the path of the snapshot file. */
+	std::string m_snapshotPath;
+
+	/** @brief Holds the number of journal records after which it is compacted, 0 to never compact. */
+	std::size_t m_compactionInterval;
+
+	/** @brief Holds the file descriptor of the journal, opened for appending. */
+	int m_journalFile;
+
+	/** @brief Holds the counters recovered when the journal was opened, with every event appended since applied. */
+	Counters m_counters;
+
+	/** @brief Holds the counters of every event committed, on the commit thread. */
+	Counters m_durableCounters;
+
+	/** @brief Holds the sequence number of the last event committed, on the commit thread. */
+	std::uint64_t m_durableSequence;
+
+	/** @brief Holds the number of records on the journal file, on the commit thread. */
+	std::size_t m_journalRecords;
+
+	/** @brief Holds the sequence number of the next event appended. */
+	std::uint64_t m_nextSequence;
+
+	/** @brief Holds the sequence number of the last event committed, as seen by the callers. */
+	std::uint64_t m_committedSequence;
+
+	/** @brief Holds the records queued, not yet committed. */
+	std::vector<Record> m_queuedRecords;
+
+	/** @brief Holds the flag value, true when a compaction was requested. */
+	bool m_compactionRequested;
+
+	/** @brief Holds the number of compaction requests served, as seen by the callers. */
+	std::size_t m_compactionCount;
+
+	/** @brief Holds the flag value, true while the commit thread is to stop. */
+	bool m_stopping;
+
+	/** @brief Holds the statistics. */
+	Stats m_stats;
+
+	/** @brief Holds the mutex which guards the queue, the counters and sequence numbers seen by the callers and the statistics. */
+	mutable std::mutex m_mutex;
+
+	/** @brief Holds the condition the commit thread is woken with. */
+	std::condition_variable m_wakeCondition;
+
+	/** @brief Holds the condition the callers waiting for a commit or compaction are woken with. */
+	std::condition_variable m_commitCondition;
+
+	/** @brief Holds the commit thread. */
+	std::thread m_commitThread;
+};
@@ -16,6 +16,9 @@
 /**
  * @brief CustomSound class which inherits Mucis object, for utility puposes
  * of playing sonds uninterruptly, after play was pressed.
+ * It streams from file, on its own thread, so it is meant for long sounds (like the music loop);
+ * short sound effects are played with SoundEffect instead.
+ * @see SoundEffect
  */
 class CustomSound : public sf::Music
 {
@@ -0,0 +1,128 @@
+/*****************************************************************
+ * \file	Delegate.hpp
+ * \brief	Header is for template class Delegate (header only)
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+template <typename Signature>
+class Delegate;
+
+/**
+ * @brief Delegate template class is a type-safe callback which never allocates: it binds a free function,
+ * a method of an object, or a small functor (e.g. a lambda capturing a few typed pointers),
+ * which is copied into an internal buffer. Calling it costs one indirect call.
+ */
+template <typename R, typename... Args>
+class Delegate<R(Args...)>
+{
+public:
+	/** @brief Holds the size of the internal buffer, in bytes, the maximum size of a bound functor. */
+	static const std::size_t BufferSize = 4 * sizeof(void*);
+
+	/**
+	 * @brief Default constructor, an empty delegate.
+	 */
+	Delegate() : m_stub(nullptr) {}
+
+	/**
+	 * @brief Static method which binds a free (or static) function.
+	 * @return The bound delegate.
+	 */
+	template <R(*Function)(Args...)>
+	static Delegate fromFunction()
+	{
+		Delegate delegate;
+		delegate.m_stub = &functionStub<Function>;
+		return delegate;
+	}
+
+	/**
+	 * @brief Static method which binds a method of an object (not the owner).
+	 * @param object The object the method is to be called on.
+	 * @return The bound delegate.
+	 */
+	template <typename T, R(T::*Method)(Args...)>
+	static Delegate fromMethod(T* object)
+	{
+		Delegate delegate;
+		new (delegate.m_storage) T*(object);
+		delegate.m_stub = &methodStub<T, Method>;
+		return delegate;
+	}
+
+	/**
+	 * @brief Static method which binds a copy of a small, trivially copyable, functor.
+	 * @param functor The functor, e.g. a lambda capturing pointers.
+	 * @return The bound delegate.
+	 */
+	template <typename Functor>
+	static Delegate fromFunctor(const Functor& functor)
+	{
+		static_assert(sizeof(Functor) <= BufferSize, "Delegate functor is too big for the internal buffer");
+		static_assert(std::is_trivially_copyable<Functor>::value, "Delegate functor must be trivially copyable");
+		static_assert(std::is_trivially_destructible<Functor>::value, "Delegate functor must be trivially destructible");
+
+		Delegate delegate;
+		new (delegate.m_storage) Functor(functor);
+		delegate.m_stub = &functorStub<Functor>;
+		return delegate;
+	}
+
+	/**
+	 * @brief Method which calls the bound callable, the delegate must not be empty.
+	 * @param args The arguments of the call.
+	 * @return The result of the call.
+	 */
+	R operator()(Args... args) const
+	{
+		return m_stub(m_storage, args...);
+	}
+
+	/**
+	 * @brief Method which checks if something is bound to the delegate.
+	 * @return The value of true if the delegate isn't empty.
+	 */
+	explicit operator bool() const
+	{
+		return m_stub != nullptr;
+	}
+
+private:
+	/**
+	 * @brief Type of the functions which restore the bound callable from the buffer and call it.
+	 */
+	typedef R(*Stub)(const void* storage, Args... args);
+
+	template <R(*Function)(Args...)>
+	static R functionStub(const void*, Args... args)
+	{
+		return Function(args...);
+	}
+
+	template <typename T, R(T::*Method)(Args...)>
+	static R methodStub(const void* storage, Args... args)
+	{
+		T* object = *static_cast<T* const*>(storage);
+		return (object->*Method)(args...);
+	}
+
+	template <typename Functor>
+	static R functorStub(const void* storage, Args... args)
+	{
+		return (*static_cast<const Functor*>(storage))(args...);
+	}
+
+	/** @brief Holds the function which calls the bound callable, nullptr if the delegate is empty. */
+	Stub m_stub;
+
+	/** @brief Holds the bound object pointer or functor. */
+	alignas(void*) unsigned char m_storage[BufferSize];
+};
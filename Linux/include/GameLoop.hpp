@@ -0,0 +1,132 @@
+/*****************************************************************
+ * \file	GameLoop.hpp
+ * \brief	Header is for class GameLoop, to be used with GameLoop.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief GameLoop class paces the game: it measures the wall time of each frame with a steady clock,
+ * accumulates it, and hands it to the simulation in fixed steps, so that the physics run at the same speed
+ * whatever the render rate. The frame time is clamped, so that a long stall (e.g. a dragged window)
+ * doesn't trigger more steps than the next frames can catch up with.
+ */
+class GameLoop
+{
+public:
+
+	/**
+	 * @brief Type of the clock the loop measures time with.
+	 */
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * @brief Structure which holds the pace metrics of the loop, measured over the last complete window.
+	 */
+	struct Metrics {
+		/** @brief Holds the number of simulation steps per second. */
+		float stepRate = 0;
+		/** @brief Holds the number of rendered frames per second. */
+		float renderRate = 0;
+		/** @brief Holds the simulation lag, the time accumulated but not yet simulated, in seconds. */
+		float lag = 0;
+		/** @brief Holds the number of frames whose time was clamped, i.e. simulation time dropped. */
+		std::size_t clampedFrames = 0;
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param stepTime The fixed simulation step, in seconds.
+	 * @param maxFrameTime The maximum frame time accumulated per frame, in seconds.
+	 * @param metricsWindow The time the rates are measured over, in seconds.
+	 */
+	GameLoop(float stepTime = 1 / 60.0f, float maxFrameTime = 0.25f, float metricsWindow = 1.0f);
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~GameLoop() = default;
+
+	/**
+	 * @brief Method which starts a new frame: measures the time since the previous one and accumulates it.
+	 * @return The measured (clamped) frame time, in seconds.
+	 */
+	float beginFrame();
+
+	/**
+	 * @brief Method which starts a new frame with a given frame time, instead of the measured one (e.g. replayed from a recording),
+	 * and accumulates it. The rates are still measured on the clock.
+	 * @param frameTime The frame time, in seconds.
+	 * @return The (clamped) frame time, in seconds.
+	 */
+	float beginFrame(float frameTime);
+
+	/**
+	 * @brief Method which consumes one fixed step from the accumulated time, to be called until it returns false.
+	 * @return The value of true if a step is to be simulated.
+	 */
+	bool step();
+
+	/**
+	 * @brief Method which gets the fixed simulation step.
+	 * @return The step time, in seconds.
+	 */
+	float getStepTime() const;
+
+	/**
+	 * @brief Method which gets how far the accumulated time is into the next step.
+	 * @return The fraction of a step not yet simulated, between 0 and 1.
+	 */
+	float getAlpha() const;
+
+	/**
+	 * @brief Method which gets the pace metrics of the loop.
+	 * @return The metrics.
+	 */
+	Metrics getMetrics() const;
+
+private:
+	/**
+	 * @brief Method which accumulates the time of a frame, clamped, and closes the metrics window if it is complete.
+	 * @param now The time the frame started.
+	 * @param frameTime The frame time, in seconds.
+	 * @return The clamped frame time, in seconds.
+	 */
+	float accumulate(Clock::time_point now, float frameTime);
+
+	/** @brief Holds the fixed simulation step, in seconds. */
+	float m_stepTime;
+
+	/** @brief Holds the maximum frame time accumulated per frame, in seconds. */
+	float m_maxFrameTime;
+
+	/** @brief Holds the time the rates are measured over, in seconds. */
+	float m_metricsWindow;
+
+	/** @brief Holds the time accumulated but not yet simulated, in seconds. */
+	double m_accumulator;
+
+	/** @brief Holds the start time of the previous frame. */
+	Clock::time_point m_previousFrame;
+
+	/** @brief Holds the flag value, true once the first frame has started. */
+	bool m_started;
+
+	/** @brief Holds the start time of the current metrics window. */
+	Clock::time_point m_windowStart;
+
+	/** @brief Holds the number of steps on the current metrics window. */
+	std::size_t m_windowSteps;
+
+	/** @brief Holds the number of frames on the current metrics window. */
+	std::size_t m_windowFrames;
+
+	/** @brief Holds the metrics of the last complete window. */
+	Metrics m_metrics;
+};
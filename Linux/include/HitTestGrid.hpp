@@ -0,0 +1,144 @@
+/*****************************************************************
+ * \file	HitTestGrid.hpp
+ * \brief	Header is for class HitTestGrid, to be used with HitTestGrid.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Window/Event.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+class ButtonInterface;
+
+namespace sf {
+	class RenderWindow;
+}
+
+/**
+ * @brief HitTestGrid class dispatches the window events to buttons through a uniform grid of their hit bounds:
+ * a mouse event only reaches the buttons under its own coordinates, looked up in the cell it falls in,
+ * and the buttons it was over on the previous mouse event, so that they see the mouse leave them.
+ * The other events reach every button. The cost of a mouse event follows the buttons of one cell, not the number of buttons.
+ */
+class HitTestGrid
+{
+public:
+	/**
+	 * @brief Structure which holds the statistics of the dispatch.
+	 */
+	struct Stats {
+		/** @brief Holds the number of events dispatched. */
+		std::size_t events = 0;
+		/** @brief Holds the number of events delivered to a button. */
+		std::size_t deliveries = 0;
+	};
+
+	/**
+	 * @brief Constructor.
+	 * @param areaSize The size of the area covered by the grid, in window coordinates; bounds outside it fall in its border cells.
+	 * @param cellSize The size of a cell, in window coordinates.
+	 */
+	HitTestGrid(const sf::Vector2f& areaSize, float cellSize = 64);
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~HitTestGrid() = default;
+
+	/**
+	 * @brief Method which adds a button, into the cells its hit bounds cover. The bounds are read once, here:
+	 * the button must not move, resize nor rotate afterwards, unless it is removed and added again.
+	 * @param button The button.
+	 */
+	void add(boost::shared_ptr<ButtonInterface> button);
+
+	/**
+	 * @brief Method which removes a button.
+	 * @param button The button.
+	 */
+	void remove(const boost::shared_ptr<ButtonInterface>& button);
+
+	/**
+	 * @brief Method which dispatches a window event to the buttons it concerns, in the order they were added.
+	 * @param window The window object reference.
+	 * @param evnt Event type occured on the window.
+	 */
+	void dispatch(sf::RenderWindow* window, const sf::Event& evnt);
+
+	/**
+	 * @brief Method which gets the number of buttons.
+	 * @return The number of buttons.
+	 */
+	std::size_t getButtonCount() const;
+
+	/**
+	 * @brief Method which gets the statistics of the dispatch.
+	 * @return The statistics.
+	 */
+	const Stats& getStats() const;
+
+private:
+	/**
+	 * @brief Structure which holds a button, with its hit bounds.
+	 */
+	struct Entry {
+		/** @brief Holds the button (not the owner). */
+		boost::shared_ptr<ButtonInterface> button;
+		/** @brief Holds the hit bounds of the button, as it was added. */
+		sf::FloatRect bounds;
+		/** @brief Holds the number of the last dispatch which delivered to the button, so it's delivered once. */
+		std::uint64_t mark;
+	};
+
+	/**
+	 * @brief Method which gets the cell a position falls in, clamped to the grid.
+	 * @param position The position, in window coordinates.
+	 * @return The cell column and row.
+	 */
+	sf::Vector2i getCell(const sf::Vector2f& position) const;
+
+	/**
+	 * @brief Method which lists every button in the cells its bounds cover.
+	 */
+	void rebuildCells();
+
+	/**
+	 * @brief Method which queues a button for delivery, if it isn't queued yet.
+	 * @param index The index of the button.
+	 */
+	void addTarget(std::uint32_t index);
+
+	/** @brief Holds the size of a cell. */
+	float m_cellSize;
+
+	/** @brief Holds the number of columns and rows of the grid. */
+	sf::Vector2i m_gridSize;
+
+	/** @brief Holds the buttons, in order of addition. */
+	std::vector<Entry> m_entries;
+
+	/** @brief Holds the indices of the buttons listed in each cell, row by row. */
+	std::vector<std::vector<std::uint32_t>> m_cells;
+
+	/** @brief Holds the indices of the buttons the last mouse event was over. */
+	std::vector<std::uint32_t> m_hovered;
+
+	/** @brief Holds the indices of the buttons an event is delivered to. */
+	std::vector<std::uint32_t> m_targets;
+
+	/** @brief Holds the number of the current dispatch. */
+	std::uint64_t m_dispatchMark;
+
+	/** @brief Holds the statistics. */
+	Stats m_stats;
+};
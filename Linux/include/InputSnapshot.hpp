@@ -0,0 +1,75 @@
+/*****************************************************************
+ * \file	InputSnapshot.hpp
+ * \brief	Header is for class InputSnapshot, to be used with InputSnapshot.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <SFML/Window/Event.hpp>
+
+/**
+ * @brief InputSnapshot class drains the window events of a frame into the events to be dispatched, in which each run
+ * of consecutive mouse moves is coalesced into its last one. A fast drag queues dozens of moves per frame, the widgets
+ * then process the hover once, while no click, nor any other event, is dropped or reordered.
+ */
+class InputSnapshot
+{
+public:
+	/**
+	 * @brief Structure which holds the statistics of the input.
+	 */
+	struct Stats {
+		/** @brief Holds the number of frames. */
+		std::size_t frames = 0;
+		/** @brief Holds the number of events received. */
+		std::size_t events = 0;
+		/** @brief Holds the number of mouse moves coalesced into a later one. */
+		std::size_t coalescedMoves = 0;
+	};
+
+	/**
+	 * @brief Default constructor.
+	 */
+	InputSnapshot();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~InputSnapshot() = default;
+
+	/**
+	 * @brief Method which begins the snapshot of a frame, clears the events of the previous one.
+	 */
+	void beginFrame();
+
+	/**
+	 * @brief Method which adds a window event, of the current frame.
+	 * @param evnt The event.
+	 */
+	void addEvent(const sf::Event& evnt);
+
+	/**
+	 * @brief Method which gets the events of the frame to be dispatched, in order, the consecutive mouse moves coalesced.
+	 * @return The events.
+	 */
+	const std::vector<sf::Event>& getEvents() const;
+
+	/**
+	 * @brief Method which gets the statistics of the input.
+	 * @return The statistics.
+	 */
+	const Stats& getStats() const;
+
+private:
+	/** @brief Holds the events of the frame, the consecutive mouse moves coalesced. */
+	std::vector<sf::Event> m_events;
+
+	/** @brief Holds the statistics. */
+	Stats m_stats;
+};
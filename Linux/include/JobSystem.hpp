@@ -0,0 +1,176 @@
+/*****************************************************************
+ * \file	JobSystem.hpp
+ * \brief	Header is for class JobSystem, to be used with JobSystem.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "Delegate.hpp"
+#include "ThreadTimer.hpp"
+
+/**
+ * @brief JobSystem class, singleton, is a pool of worker threads which split index ranges between them.
+ * Each worker has its own queue of range tasks; when it runs out, it steals the oldest tasks of the other workers,
+ * so that the load balances itself when some ranges take longer than others.
+ * The calling thread also runs tasks while it waits, so parallelFor() is never slower than a plain loop by much.
+ */
+class JobSystem {
+public:
+
+	/**
+	 * @brief Type of the job run over each subrange, [begin, end), it may be called from several threads at once.
+	 */
+	typedef Delegate<void(std::size_t, std::size_t)> RangeJob;
+
+	/**
+	 * @brief Structure which holds the usage statistics of a worker.
+	 */
+	struct WorkerStats {
+		/** @brief Holds the number of tasks run by the worker. */
+		std::size_t tasks = 0;
+		/** @brief Holds the number of those tasks stolen from another worker. */
+		std::size_t stolen = 0;
+		/** @brief Holds the time spent running tasks, in seconds. */
+		double busyTime = 0;
+		/** @brief Holds the fraction of the time, since the worker started, spent running tasks. */
+		double utilization = 0;
+	};
+
+	/**
+	 * @brief Method which gets the instance of JobSystem singleton.
+	 * It starts one worker less than the hardware threads, the calling thread being the last one.
+	 * @return The instance of the JobSystem singleton.
+	 */
+	static JobSystem& getInstance();
+
+	/**
+	 * @brief Method which sets the number of worker threads, waiting for the current ones to finish.
+	 * It is not to be called while a parallelFor() is running.
+	 * @param workers The number of workers, 0 runs every job on the calling thread.
+	 */
+	static void setWorkerCount(std::size_t workers);
+
+	/**
+	 * @brief Method which gets the number of worker threads.
+	 * @return The number of workers.
+	 */
+	static std::size_t getWorkerCount();
+
+	/**
+	 * @brief Method which runs a job over [begin, end), split in subranges of grainSize indexes run by every worker,
+	 * and waits for all of them. It must not be called from inside a job.
+	 * @param begin The first index.
+	 * @param end The index past the last one.
+	 * @param grainSize The number of indexes of each subrange, ranges no longer than it run on the calling thread only.
+	 * @param job The job, run once per subrange.
+	 */
+	static void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const RangeJob& job);
+
+	/**
+	 * @brief Method which gets the usage statistics of every worker.
+	 * @return The statistics, one per worker.
+	 */
+	static std::vector<WorkerStats> getWorkerStats();
+
+private:
+	/**
+	 * @brief Structure which holds a subrange to be run.
+	 */
+	struct Task {
+		/** @brief Holds the job to be run (not the owner). */
+		const RangeJob* job;
+		/** @brief Holds the first index of the subrange. */
+		std::size_t begin;
+		/** @brief Holds the index past the last one of the subrange. */
+		std::size_t end;
+		/** @brief Holds the number of tasks of the parallelFor() still to be finished (not the owner). */
+		std::atomic<std::size_t>* remaining;
+	};
+
+	/**
+	 * @brief Structure which holds a worker thread and its queue.
+	 */
+	struct Worker {
+		/** @brief Holds the queue of tasks, the worker takes the newest, thieves take the oldest. */
+		std::deque<Task> tasks;
+		/** @brief Holds the mutex which guards the queue. */
+		std::mutex mutex;
+		/** @brief Holds the thread. */
+		std::thread thread;
+		/** @brief Holds the timing of the tasks run. */
+		ThreadTimer timer;
+		/** @brief Holds the time the worker started. */
+		ThreadTimer::Clock::time_point startTime;
+		/** @brief Holds the number of tasks stolen from other workers. */
+		std::atomic<std::size_t> stolen;
+	};
+
+	/**
+	 * @brief Default constructor (private).
+	 */
+	JobSystem();
+
+	/**
+	 * @brief Destructor (private), stops the workers.
+	 */
+	~JobSystem();
+
+	/**
+	 * @brief Method which starts a number of workers.
+	 * @param workers The number of workers.
+	 */
+	void startWorkers(std::size_t workers);
+
+	/**
+	 * @brief Method which stops every worker and waits for them.
+	 */
+	void stopWorkers();
+
+	/**
+	 * @brief Method which runs the tasks of a worker, until the pool stops.
+	 * @param index The index of the worker.
+	 */
+	void workerLoop(std::size_t index);
+
+	/**
+	 * @brief Method which takes a task, from the own queue first, otherwise stolen from another one.
+	 * @param index The index of the worker taking it, or the number of workers for the calling thread.
+	 * @param task The task taken.
+	 * @return The value of true if a task was taken.
+	 */
+	bool takeTask(std::size_t index, Task& task);
+
+	/**
+	 * @brief Static method which runs a task and marks it finished.
+	 * @param task The task.
+	 */
+	static void runTask(const Task& task);
+
+	/** @brief Holds the workers. */
+	std::vector<boost::shared_ptr<Worker>> m_workers;
+
+	/** @brief Holds the number of tasks queued, not yet taken. */
+	std::atomic<std::size_t> m_queuedTasks;
+
+	/** @brief Holds the flag value, true while the workers are to stop. */
+	bool m_stopping;
+
+	/** @brief Holds the mutex the idle workers sleep on. */
+	std::mutex m_wakeMutex;
+
+	/** @brief Holds the condition the idle workers are woken with. */
+	std::condition_variable m_wakeCondition;
+};
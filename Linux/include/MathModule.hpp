@@ -9,12 +9,15 @@
 #pragma once
 
 #include <math.h>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * @brief MathModule static class, works as a namespace,
  * main utility is to generate random float numbers from an interval
  * also, including this class will include math.h, the idea  of this class is to be expanded
- * for the use of more utility math functions.
+ * for the use of more utility math functions, e.g. checksums.
+ * Random numbers are drawn from the RandomEngine of the calling thread, so it is thread safe.
  */
 class MathModule {
 public:
@@ -23,19 +26,37 @@ public:
 	 * @brief Static method which returns a random number within an interval of values
 	 * @param lowestInterval The lower interval of the random value to be generated.
 	 * @param highestInterval The higher interval of the random value to be generated.
-	 * @return A random value within the interval.
+	 * @return A random value within the interval, with the full precision of a float.
 	 */
 	static float getRandom(float lowestInterval, float highestInterval);
 
-private:
+	/**
+	 * @brief Static method which fills an array with random numbers within an interval of values, in bulk.
+	 * @param values The array to be filled.
+	 * @param count The number of values.
+	 * @param lowestInterval The lower interval of the random values to be generated.
+	 * @param highestInterval The higher interval of the random values to be generated.
+	 */
+	static void fillRandom(float* values, std::size_t count, float lowestInterval, float highestInterval);
 
-	/** @brief Holds the seed value of the random generator */
-	static const long long m_ramdomizationSeed;
+	/**
+	 * @brief Static method which sets the seed of the random generators, to replay the same random sequences.
+	 * By default, the seed is based on the time the game started.
+	 * @param seed The seed.
+	 */
+	static void setRandomSeed(std::uint64_t seed);
+
+	/**
+	 * @brief Static method which gets the seed of the random generators.
+	 * @return The seed.
+	 */
+	static std::uint64_t getRandomSeed();
 
 	/**
-	 * @brief Static method which returns a seed based on the current time
-	 * to be used on the random number generator.
-	 * @return A seed based on the current time.
+	 * @brief Static method which computes the CRC-32 (IEEE) checksum of a block of bytes.
+	 * @param data The bytes.
+	 * @param size The number of bytes.
+	 * @return The checksum.
 	 */
-	static long long generateSeed();
-};
\ No newline at end of file
+	static std::uint32_t getChecksum(const void* data, std::size_t size);
+};
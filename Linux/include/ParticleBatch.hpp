@@ -0,0 +1,104 @@
+/*****************************************************************
+ * \file	ParticleBatch.hpp
+ * \brief	Header is for class ParticleBatch, to be used with ParticleBatch.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include "WindowInterface.hpp"
+#include "ParticleSystem.hpp"
+
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+#include <boost/shared_ptr.hpp>
+
+class PolyParticleShape;
+
+/**
+ * @brief ParticleBatch class renders every visible particle sharing the same texture
+ * with a single draw call: the particle polygons are cached once, in local coordinates,
+ * and each frame they are moved to the (interpolated) positions of a ParticleSystem::Frame into one triangle VertexArray.
+ * It never reads the ParticleSystem itself, so that it can render while another thread updates it.
+ */
+class ParticleBatch : public WindowInterface
+{
+public:
+	/**
+	 * @brief Default constructor.
+	 */
+	ParticleBatch();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~ParticleBatch() = default;
+
+	/**
+	 * @brief Method which adds a particle to the batch, its polygon, color and texture coordinates are cached,
+	 * so it should be called after the particle has been set up. All the particles of a batch must share the same texture.
+	 * @param particle The particle shape.
+	 */
+	void addParticle(const PolyParticleShape& particle);
+
+	/**
+	 * @brief Method which sets the frame to be rendered, it must outlive its rendering.
+	 * @param frame The frame which holds the particle positions, nullptr renders nothing.
+	 * @param alpha The interpolation factor between the previous and the last positions of the frame.
+	 */
+	void setFrame(const ParticleSystem::Frame* frame, float alpha);
+
+	/**
+	 * @brief Method which gets the number of vertices submitted on the last draw.
+	 * @return The number of vertices.
+	 */
+	std::size_t getVertexCount() const;
+
+	/**
+	 * @brief Method which draws all the visible particles of the batch to a specific window, in one draw call.
+	 * @param target The render target, a window or an offscreen texture.
+	 */
+	void drawTo(sf::RenderTarget* target) override;
+
+	/**
+	 * @brief Method which gets the texture a draw pass uses.
+	 * @param pass The draw pass, the whole batch.
+	 * @return The texture shared by the particles, nullptr if none.
+	 * @see WindowInterface
+	 */
+	const sf::Texture* getDrawPassTexture(std::size_t pass) const override;
+
+private:
+	/**
+	 * @brief Structure which locates the cached polygon of a particle.
+	 */
+	struct Mesh {
+		/** @brief Holds the index of the particle within the ParticleSystem. */
+		ParticleSystem::Index index;
+		/** @brief Holds the first vertex of the polygon on \pm_localVertices. */
+		std::size_t firstVertex;
+		/** @brief Holds the number of vertices of the polygon. */
+		std::size_t vertexCount;
+	};
+
+	/** @brief Holds the frame to be rendered (not the owner). */
+	const ParticleSystem::Frame* m_frame;
+
+	/** @brief Holds the interpolation factor of the frame positions. */
+	float m_alpha;
+
+	/** @brief Holds the Texture reference shared by all the particles of the batch, if there is one. */
+	boost::shared_ptr<sf::Texture> m_texture;
+
+	/** @brief Holds the polygon location of each particle of the batch. */
+	std::vector<Mesh> m_meshes;
+
+	/** @brief Holds the cached polygons of the particles, in local coordinates. */
+	std::vector<sf::Vertex> m_localVertices;
+
+	/** @brief Holds the vertices submitted to the window, rebuilt every frame. */
+	sf::VertexArray m_vertices;
+};
@@ -9,39 +9,34 @@
 #pragma once
 
 #include <string>
-#include <map>
 
 #include <SFML/System/Vector2.hpp>
 #include <boost/shared_ptr.hpp>
 
-class CustomSound;
+#include "ParticleSystem.hpp"
+
+class SoundEffect;
 
 /**
- * @brief ParticleInterface class hadles common behaviour of particles and their properties,
- * as well as forcing the implementation of common behaviours of such.
+ * @brief ParticleInterface class hadles common behaviour of particles and their properties.
+ * It is a thin view over one particle of a ParticleSystem, which is the owner of the physical state,
+ * and is updated in bulk by it.
+ * @see ParticleSystem
  */
 class ParticleInterface
 {
 public:
 
 	/**
-	 * @brief Structure composed of phyical state variables
+	 * @brief Type of the phyical state variables, stored by the ParticleSystem.
 	 */
-	struct State {
-		/** @brief Holds the 2d position physical property. */
-		sf::Vector2f position = { 0,0 };
-
-		/** @brief Holds the 2d velocity physical property. */
-		sf::Vector2f velocity = { 0,0 };
-
-		/** @brief Holds the 2d acceleration physical property. */
-		sf::Vector2f acceleration = { 0,0 };
-	};
+	typedef ParticleSystem::State State;
 
 	/**
-	 * @brief Default constructor.
+	 * @brief Constructor, allocates a new particle in the system.
+	 * @param system The particle system which holds the particle state.
 	 */
-	ParticleInterface();
+	ParticleInterface(boost::shared_ptr<ParticleSystem> system);
 
 	/**
 	 * @brief Default destructor.
@@ -49,51 +44,47 @@ public:
 	~ParticleInterface() = default;
 
 	/**
-	 * @brief Method which forces child classes to update the internal state of the object
-	 * based on deltaTime.
-	 * @param deltaTime The time interval to update the differential equations.
-	 */
-	virtual void updatePhysics(float deltaTime) = 0;
-
-	/**
-	 * @brief Method which forces child classes to set the internal birth state of the object.
+	 * @brief Method which sets the internal birth state of the object.
 	 * @param state The state to be born with.
 	 * @param timeOfBirth The time the objects is suposed to be born.
 	 */
-	virtual void setBirthState(const State& state, float timeOfBirth = 0) = 0;
+	void setBirthState(const State& state, float timeOfBirth = 0);
 
 	/**
-	 * @brief Method which forces child classes to set the internal reset state of the object.
+	 * @brief Method which sets the internal reset state of the object.
 	 * @param state The state to be reset with.
 	 */
-	virtual void setResetState(const State& state) = 0;
+	void setResetState(const State& state);
 
 	/**
-	 * @brief Method which forces child classes to implement a birth behaviour.
+	 * @brief Method which implements a birth behaviour.
 	 */
-	virtual void birth() = 0;
+	virtual void birth();
 
 	/**
-	 * @brief Method which forces child classes to implement a death behaviour.
+	 * @brief Method which implements a death behaviour.
 	 */
-	virtual void death() = 0;
+	virtual void death();
 
 	/**
-	 * @brief Method which forces child classes to implement a resetToBirthState behaviour.
+	 * @brief Method which is called when the particle reaches its time of birth, and becomes visible.
 	 */
-	virtual void resetToBirthState() = 0;
-
-	//TODO: eventually setTrajectory()
+	virtual void onBorn();
 
-	//TODO: eventually setBirthCallback()
+	/**
+	 * @brief Method which is called when the particle dies, either by death() or by the ParticleSystem death condition.
+	 * @see ParticleSystem::setDeathCondition()
+	 */
+	virtual void onDeath();
 
 	/**
-	 * @brief Method which sets the death vericication callback, in is called on updatePhysics.
-	 * @param callback A function pointer.
-	 * @param argsMap The function's arguments map.
-	 * @see updatePhysics()
+	 * @brief Method which implements a resetToBirthState behaviour.
 	 */
-	virtual void setDeathCondition(bool (*callback)(std::map<std::string, void*>), const std::map<std::string, void*>& argsMap);
+	void resetToBirthState();
+
+	//TODO: eventually setTrajectory()
+
+	//TODO: eventually setBirthCallback()
 
 	/**
 	 * @brief Method which checks if the current particle is alive or dead.
@@ -101,6 +92,12 @@ public:
 	 */
 	bool isAlive() const;
 
+	/**
+	 * @brief Method which checks if the current particle is alive and was already born.
+	 * @return The value of true if the current particle is to be rendered.
+	 */
+	bool isVisible() const;
+
 	/**
 	 * @brief Method which sets and loads the birth behaviour sound.
 	 * @param path The path of the sound to be played.
@@ -133,43 +130,28 @@ public:
 	 */
 	State getState() const;
 
-protected:
-	/** @brief Holds the current state of the particle. */
-	State p_state;
+	/**
+	 * @brief Method which gets the index of the particle within its ParticleSystem.
+	 * @return The index of the particle.
+	 */
+	ParticleSystem::Index getIndex() const;
 
-	/** @brief Holds the reset state of the particle. */
-	State p_resetState;
+protected:
+	/** @brief Holds the ParticleSystem reference, which owns the particle state. */
+	boost::shared_ptr<ParticleSystem> p_system;
 
-	/** @brief Holds the flag value, true if the partile is alive. */
-	bool p_isAlive = false;
+	/** @brief Holds the index of the particle within \pp_system. */
+	ParticleSystem::Index p_index;
 
-	/** @brief Holds the CustomSound reference for the birth sound, if it is allocated. */
-	boost::shared_ptr<CustomSound> p_birthSound;
+	/** @brief Holds the SoundEffect reference for the birth sound, if it is allocated. */
+	boost::shared_ptr<SoundEffect> p_birthSound;
 
 	/** @brief Holds the flag value, true if the birth sound is active. */
 	bool p_birthSoundActive;
 
-	/** @brief Holds the CustomSound reference for the death sound, if it is allocated. */
-	boost::shared_ptr<CustomSound> p_deathSound;
+	/** @brief Holds the SoundEffect reference for the death sound, if it is allocated. */
+	boost::shared_ptr<SoundEffect> p_deathSound;
 
 	/** @brief Holds the flag value, true if the death sound is active. */
 	bool p_deathSoundActive;
-
-	/**
-	 * @brief Holds the callback function to be called when setDeathCondition is evoked.
-	 * @see setDeathCondition()
-	 */
-	bool (*p_deathCondition)(std::map<std::string, void*>);
-
-	/**
-	 * @brief Holds the parameters of the callback function to be called when setDeathCondition is evoked.
-	 * @see setDeathCondition()
-	 */
-	std::map<std::string, void*> p_deathConditionArgsMap;
-
-	/** @brief Holds the value of the time the object should be born. */
-	float p_timeOfBirth;
-
-	/** @brief Holds the value of the time the object has been 'physically' alive. */
-	float p_timeAlive;
 };
\ No newline at end of file
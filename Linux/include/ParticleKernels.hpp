@@ -0,0 +1,90 @@
+/*****************************************************************
+ * \file	ParticleKernels.hpp
+ * \brief	Header is for class ParticleKernels, to be used with ParticleKernels.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief ParticleKernels static class, works as a namespace, holds the bulk (vectorized) kernels
+ * used by ParticleSystem to update the particle arrays. The instruction set is chosen at runtime:
+ * AVX2 when the cpu supports it, SSE2 otherwise, and a scalar fallback on non x86 builds.
+ * Every path produces exactly the same results as the scalar one.
+ */
+class ParticleKernels {
+public:
+
+	/**
+	 * @brief Type which identifies the instruction set used by the kernels.
+	 */
+	enum InstructionSet {
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	/**
+	 * @brief Structure which holds the particle arrays the kernels work on.
+	 */
+	struct Arrays {
+		/** @brief Holds the x position array. */
+		float* positionX;
+		/** @brief Holds the y position array. */
+		float* positionY;
+		/** @brief Holds the x velocity array. */
+		float* velocityX;
+		/** @brief Holds the y velocity array. */
+		float* velocityY;
+		/** @brief Holds the x acceleration array. */
+		const float* accelerationX;
+		/** @brief Holds the y acceleration array. */
+		const float* accelerationY;
+		/** @brief Holds the flag array (non zero to integrate the particle). */
+		const unsigned char* active;
+	};
+
+	/**
+	 * @brief Static method which runs one euler integration step over the active particles of [begin, end)
+	 * (velocity += deltaTime * acceleration; position += deltaTime * velocity).
+	 * @param arrays The particle arrays.
+	 * @param begin The index of the first particle.
+	 * @param end The index after the last particle.
+	 * @param deltaTime The time interval to update the differential equations.
+	 */
+	static void integrateEuler(const Arrays& arrays, std::size_t begin, std::size_t end, float deltaTime);
+
+	/**
+	 * @brief Static method which gets the instruction set currently used by the kernels.
+	 * @return The instruction set.
+	 */
+	static InstructionSet getInstructionSet();
+
+	/**
+	 * @brief Static method which forces the kernels to use an instruction set, it is
+	 * clamped to the best instruction set supported by the cpu.
+	 * @param instructionSet The instruction set to be used.
+	 */
+	static void setInstructionSet(InstructionSet instructionSet);
+
+	/**
+	 * @brief Static method which gets the best instruction set supported by the cpu.
+	 * @return The instruction set.
+	 */
+	static InstructionSet getSupportedInstructionSet();
+
+	/**
+	 * @brief Static method which gets the name of an instruction set, for logging purposes.
+	 * @param instructionSet The instruction set.
+	 * @return The name of the instruction set.
+	 */
+	static const char* getInstructionSetName(InstructionSet instructionSet);
+
+private:
+	/** @brief Holds the instruction set currently used by the kernels. */
+	static InstructionSet m_instructionSet;
+};
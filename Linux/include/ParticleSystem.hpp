@@ -0,0 +1,460 @@
+/*****************************************************************
+ * \file	ParticleSystem.hpp
+ * \brief	Header is for class ParticleSystem, to be used with ParticleSystem.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "Delegate.hpp"
+#include "TimerWheel.hpp"
+
+/**
+ * @brief ParticleSystem class holds the physical state of every particle in contiguous arrays
+ * (structure of arrays), so that a single pass can update all particles without chasing pointers.
+ * Particle objects (ParticleInterface) act as thin views over one index of this system.
+ * Births, and the deaths it can predict, are scheduled on a TimerWheel as the particles are launched,
+ * so an update only visits the particles whose birth or death is due, besides moving the visible ones.
+ */
+class ParticleSystem
+{
+public:
+	/**
+	 * @brief Type which identifies a particle inside the system.
+	 */
+	typedef std::size_t Index;
+
+	/**
+	 * @brief Structure composed of phyical state variables
+	 */
+	struct State {
+		/** @brief Holds the 2d position physical property. */
+		sf::Vector2f position = { 0,0 };
+
+		/** @brief Holds the 2d velocity physical property. */
+		sf::Vector2f velocity = { 0,0 };
+
+		/** @brief Holds the 2d acceleration physical property. */
+		sf::Vector2f acceleration = { 0,0 };
+	};
+
+	/**
+	 * @brief Type which identifies how the particles move.
+	 * Euler integrates their state step by step; Analytic evaluates their closed form trajectory (constant acceleration)
+	 * at their time since birth, without cumulative error, and predicts their death time from the death boundary.
+	 */
+	enum Kinematics {
+		Euler,
+		Analytic
+	};
+
+	/**
+	 * @brief Structure which holds a copy of what is needed to render the particles, e.g. to be handed to another thread.
+	 */
+	struct Frame {
+		/** @brief Holds the x position of each particle before the last update. */
+		std::vector<float> previousPositionX;
+		/** @brief Holds the y position of each particle before the last update. */
+		std::vector<float> previousPositionY;
+		/** @brief Holds the x position of each particle. */
+		std::vector<float> positionX;
+		/** @brief Holds the y position of each particle. */
+		std::vector<float> positionY;
+		/** @brief Holds the visible flag of each particle (1 if alive and born). */
+		std::vector<unsigned char> visible;
+
+		/**
+		 * @brief Method which gets the position of a particle, interpolated between the previous and the last update.
+		 * @param index The index of the particle.
+		 * @param alpha The interpolation factor, 0 is the previous position and 1 the last one.
+		 * @return The interpolated position of the particle.
+		 */
+		sf::Vector2f getInterpolatedPosition(Index index, float alpha) const;
+	};
+
+	/**
+	 * @brief Default constructor.
+	 */
+	ParticleSystem();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~ParticleSystem() = default;
+
+	/**
+	 * @brief Method which reserves memory for a number of particles, to avoid reallocations while adding them.
+	 * @param capacity The number of particles to reserve memory for.
+	 */
+	void reserve(std::size_t capacity);
+
+	/**
+	 * @brief Method which allocates a new (dead) particle in the system.
+	 * @return The index of the new particle.
+	 */
+	Index addParticle();
+
+	/**
+	 * @brief Method which gets the number of particles allocated in the system.
+	 * @return The number of particles.
+	 */
+	std::size_t getParticleCount() const;
+
+	/**
+	 * @brief Type of the death condition, called for each visible particle on update, true kills the particle.
+	 * It is evaluated in parallel, so it must only read the system.
+	 */
+	typedef Delegate<bool(const ParticleSystem&, Index)> DeathCondition;
+
+	/**
+	 * @brief Method which advances the clock of the system by deltaTime, bearing the particles whose birth is due,
+	 * updates the internal state of every visible particle (see Kinematics), and then kills the ones whose predicted death is due,
+	 * or evaluates the death condition of the visible ones if their death can't be predicted. The positions before the update are kept,
+	 * to interpolate the rendered positions between updates.
+	 * The integration and the death condition are split between the JobSystem workers, in ranges of the parallel grain size.
+	 * The indexes of the particles born and killed during this update are kept in getBornParticles() and getDiedParticles().
+	 * @param deltaTime The time interval to update the differential equations.
+	 */
+	void update(float deltaTime);
+
+	/**
+	 * @brief Method which sets the number of particles updated by each parallel task, fewer particles are updated on the calling thread only.
+	 * @param grainSize The number of particles, rounded up to a multiple of 8 (a vector register).
+	 */
+	void setParallelGrainSize(std::size_t grainSize);
+
+	/**
+	 * @brief Method which sets how the particles move, see Kinematics. Euler by default.
+	 * @param kinematics The kinematics.
+	 */
+	void setKinematics(Kinematics kinematics);
+
+	/**
+	 * @brief Method which gets how the particles move.
+	 * @return The kinematics.
+	 */
+	Kinematics getKinematics() const;
+
+	/**
+	 * @brief Method which sets the death boundary, a half plane: the visible particles with dot(normal, position) < offset die.
+	 * With Analytic kinematics, the death time of each particle is solved from it, and the death condition isn't evaluated.
+	 * @param normal The normal of the boundary, pointing to the side where the particles live.
+	 * @param offset The offset of the boundary, along its normal.
+	 */
+	void setDeathBoundary(const sf::Vector2f& normal, float offset);
+
+	/**
+	 * @brief Method which gets the time a particle is born, since it was launched by birth().
+	 * @param index The index of the particle.
+	 * @return The time, in seconds.
+	 */
+	float getBirthTime(Index index) const;
+
+	/**
+	 * @brief Method which gets the time a particle dies, since it was launched by birth(), solved from its birth state and the death boundary.
+	 * @param index The index of the particle.
+	 * @return The time, in seconds, infinity if it never crosses the death boundary, or there is none.
+	 */
+	float getDeathTime(Index index) const;
+
+	/**
+	 * @brief Method which jumps every launched particle to a time since its launch, forwards or backwards, with Analytic kinematics:
+	 * particles are born, revived or killed as they would have been at that time, without raising their events,
+	 * except the all dead callback if the last alive particle dies.
+	 * @param time The time since launch, in seconds.
+	 * @return The value of true if the jump was made, false with Euler kinematics.
+	 */
+	bool seek(float time);
+
+	/**
+	 * @brief Method which sets the birth state of a particle, which is also saved as its reset state.
+	 * @param index The index of the particle.
+	 * @param state The state to be born with.
+	 * @param timeOfBirth The time the particle is suposed to be born.
+	 */
+	void setBirthState(Index index, const State& state, float timeOfBirth = 0);
+
+	/**
+	 * @brief Method which sets the reset state of a particle.
+	 * @param index The index of the particle.
+	 * @param state The state to be reset with.
+	 */
+	void setResetState(Index index, const State& state);
+
+	/**
+	 * @brief Method which resets a particle to its reset state.
+	 * @param index The index of the particle.
+	 */
+	void resetToBirthState(Index index);
+
+	/**
+	 * @brief Method which sets a particle alive, it becomes visible once its time of birth is reached.
+	 * @param index The index of the particle.
+	 */
+	void birth(Index index);
+
+	/**
+	 * @brief Method which sets a particle dead.
+	 * @param index The index of the particle.
+	 */
+	void kill(Index index);
+
+	/**
+	 * @brief Method which resets every particle to its birth state and births it, i.e. restarts a play.
+	 */
+	void rebirthAll();
+
+	/**
+	 * @brief Method which checks if a particle is alive.
+	 * @param index The index of the particle.
+	 * @return The value of true if the particle is alive.
+	 */
+	bool isAlive(Index index) const;
+
+	/**
+	 * @brief Method which checks if a particle is alive and its time of birth has been reached.
+	 * @param index The index of the particle.
+	 * @return The value of true if the particle is to be rendered.
+	 */
+	bool isVisible(Index index) const;
+
+	/**
+	 * @brief Method which gets the number of particles alive, kept up to date on every birth and death.
+	 * @return The number of particles alive.
+	 */
+	std::size_t getAliveCount() const;
+
+	/**
+	 * @brief Method which sets the death condition, evaluated on update.
+	 * @param condition The condition, with its bound context.
+	 */
+	void setDeathCondition(const DeathCondition& condition);
+
+	/**
+	 * @brief Method which sets the callback called once, when the last alive particle dies.
+	 * @param callback The callback, with its bound context.
+	 */
+	void setAllDeadCallback(const Delegate<void()>& callback);
+
+	/**
+	 * @brief Method which gets the current state of a particle.
+	 * @param index The index of the particle.
+	 * @return The current state of the particle.
+	 */
+	State getState(Index index) const;
+
+	/**
+	 * @brief Method which gets the current position of a particle.
+	 * @param index The index of the particle.
+	 * @return The current position of the particle.
+	 */
+	sf::Vector2f getPosition(Index index) const;
+
+	/**
+	 * @brief Method which sets how far the rendered positions are between the previous and the last update.
+	 * @param alpha The interpolation factor, 0 renders the previous positions and 1 the last ones.
+	 */
+	void setInterpolationAlpha(float alpha);
+
+	/**
+	 * @brief Method which gets the position of a particle to be rendered, interpolated between the previous and the last update.
+	 * @param index The index of the particle.
+	 * @return The interpolated position of the particle.
+	 * @see setInterpolationAlpha()
+	 */
+	sf::Vector2f getInterpolatedPosition(Index index) const;
+
+	/**
+	 * @brief Method which copies the render state of every particle into a frame, reusing its memory.
+	 * @param frame The frame to be written.
+	 */
+	void copyFrame(Frame& frame) const;
+
+	/**
+	 * @brief Method which gets the number of bytes writeSnapshot() writes.
+	 * @return The number of bytes.
+	 */
+	std::size_t getSnapshotSize() const;
+
+	/**
+	 * @brief Method which writes the whole physical state of every particle (current, previous, birth states, lifetimes and flags)
+	 * into a block of bytes, to be restored with readSnapshot().
+	 * @param data The block, of getSnapshotSize() bytes.
+	 */
+	void writeSnapshot(unsigned char* data) const;
+
+	/**
+	 * @brief Method which restores the state written by writeSnapshot(), into a system with the same number of particles.
+	 * @param data The block.
+	 * @param size The number of bytes of the block.
+	 * @return The value of true if it was restored, false if the block doesn't match the particles.
+	 */
+	bool readSnapshot(const unsigned char* data, std::size_t size);
+
+	/**
+	 * @brief Method which gets the indexes of the particles born on the last update.
+	 * @return The vector of particle indexes.
+	 */
+	const std::vector<Index>& getBornParticles() const;
+
+	/**
+	 * @brief Method which gets the indexes of the particles killed by the death condition, or their predicted death, on the last update.
+	 * @return The vector of particle indexes.
+	 */
+	const std::vector<Index>& getDiedParticles() const;
+
+private:
+	/**
+	 * @brief Method which evaluates the death condition of a range of particles into their death flags.
+	 * @param begin The first index.
+	 * @param end The index past the last one.
+	 */
+	void flagDying(std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Method which evaluates the trajectory of a range of particles at their time since birth, with Analytic kinematics.
+	 * @param begin The first index.
+	 * @param end The index past the last one.
+	 */
+	void evaluateTrajectories(std::size_t begin, std::size_t end);
+
+	/**
+	 * @brief Method which solves the death time of a particle, since its birth, from its reset state and the death boundary.
+	 * @param index The index of the particle.
+	 */
+	void solveDeathTime(Index index);
+
+	/**
+	 * @brief Method which checks if the deaths are predicted, Analytic kinematics with a death boundary.
+	 * @return The value of true if they are.
+	 */
+	bool isDeathPredicted() const;
+
+	/**
+	 * @brief Method which (re)schedules the birth of a particle, if it is alive and not born yet,
+	 * and its death, if it is alive and predicted, cancelling the ones scheduled before.
+	 * @param index The index of the particle.
+	 */
+	void scheduleParticle(Index index);
+
+	/**
+	 * @brief Method which drops every scheduled birth and death, sets the timers to the clock of the system, and schedules them again.
+	 */
+	void rescheduleAll();
+
+	/**
+	 * @brief Method which writes a state into the current state arrays, without interpolating from the previous position.
+	 * @param index The index of the particle.
+	 * @param state The state to be written.
+	 */
+	void writeState(Index index, const State& state);
+
+	/** @brief Holds the x position of each particle. */
+	std::vector<float> m_positionX;
+
+	/** @brief Holds the y position of each particle. */
+	std::vector<float> m_positionY;
+
+	/** @brief Holds the x position of each particle before the last update. */
+	std::vector<float> m_previousPositionX;
+
+	/** @brief Holds the y position of each particle before the last update. */
+	std::vector<float> m_previousPositionY;
+
+	/** @brief Holds the x velocity of each particle. */
+	std::vector<float> m_velocityX;
+
+	/** @brief Holds the y velocity of each particle. */
+	std::vector<float> m_velocityY;
+
+	/** @brief Holds the x acceleration of each particle. */
+	std::vector<float> m_accelerationX;
+
+	/** @brief Holds the y acceleration of each particle. */
+	std::vector<float> m_accelerationY;
+
+	/** @brief Holds the time each particle should be born. */
+	std::vector<float> m_timeOfBirth;
+
+	/** @brief Holds the time each particle was launched, by birth(), on the clock of the system. */
+	std::vector<double> m_launchTime;
+
+	/** @brief Holds the birth timer of each particle, 0 if none is pending. */
+	std::vector<TimerWheel::TimerId> m_birthTimer;
+
+	/** @brief Holds the death timer of each particle, 0 if none is pending. */
+	std::vector<TimerWheel::TimerId> m_deathTimer;
+
+	/** @brief Holds the alive flag of each particle (1 if alive). */
+	std::vector<unsigned char> m_alive;
+
+	/** @brief Holds the visible flag of each particle (1 if alive and born). */
+	std::vector<unsigned char> m_visible;
+
+	/** @brief Holds the death flag of each particle (1 if the death condition was met on the last update). */
+	std::vector<unsigned char> m_dying;
+
+	/** @brief Holds the reset state of each particle. */
+	std::vector<State> m_resetState;
+
+	/** @brief Holds the launched flag of each particle (1 once birth() was called on it). */
+	std::vector<unsigned char> m_launched;
+
+	/** @brief Holds the death time of each particle, since its birth, infinity if it never dies. */
+	std::vector<float> m_deathTime;
+
+	/** @brief Holds how the particles move. */
+	Kinematics m_kinematics;
+
+	/** @brief Holds the flag value, true if a death boundary is set. */
+	bool m_hasDeathBoundary;
+
+	/** @brief Holds the normal of the death boundary. */
+	sf::Vector2f m_deathBoundaryNormal;
+
+	/** @brief Holds the offset of the death boundary, along its normal. */
+	float m_deathBoundaryOffset;
+
+	/** @brief Holds the clock of the system, the time updated so far, in seconds. */
+	double m_clock;
+
+	/** @brief Holds the timers of the births and predicted deaths, on the clock of the system. */
+	TimerWheel m_timers;
+
+	/** @brief Holds the indexes of the particles whose predicted death fired on the current update. */
+	std::vector<Index> m_dueDeaths;
+
+	/** @brief Holds the indexes of the particles born on the last update. */
+	std::vector<Index> m_bornParticles;
+
+	/** @brief Holds the indexes of the particles killed by the death condition, or their predicted death, on the last update. */
+	std::vector<Index> m_diedParticles;
+
+	/** @brief Holds the number of particles updated by each parallel task. */
+	std::size_t m_parallelGrainSize;
+
+	/** @brief Holds the interpolation factor of the rendered positions. */
+	float m_interpolationAlpha;
+
+	/** @brief Holds the number of particles alive. */
+	std::size_t m_aliveCount;
+
+	/**
+	 * @brief Holds the death condition.
+	 * @see setDeathCondition()
+	 */
+	DeathCondition m_deathCondition;
+
+	/**
+	 * @brief Holds the callback to be called when the last alive particle dies.
+	 * @see setAllDeadCallback()
+	 */
+	Delegate<void()> m_allDeadCallback;
+};
@@ -11,6 +11,7 @@
 #include "WindowInterface.hpp"
 #include "ParticleInterface.hpp"
 #include <string>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
@@ -35,12 +36,14 @@ public:
 
 	/**
 	 * @brief Constructor.
+	 * @param system The particle system which holds the particle state.
 	 * @param pos The position of the particle.
 	 * @param nPoints The number of poins of the polygon.
 	 * @param radius The radius of the polygon.
 	 * @param backgroundColor The base color of the polygon.
 	 */
 	PolyParticleShape(
+		boost::shared_ptr<ParticleSystem> system,
 		const sf::Vector2f& pos,
 		int nPoints,
 		float radius,
@@ -48,12 +51,14 @@ public:
 
 	/**
 	 * @brief Constructor.
+	 * @param system The particle system which holds the particle state.
 	 * @param pos The position of the particle.
 	 * @param nPoints The number of poins of the polygon.
 	 * @param radius The radusi of the polygon.
 	 * @param path The path to the texture of the polygon.
 	 */
 	PolyParticleShape(
+		boost::shared_ptr<ParticleSystem> system,
 		const sf::Vector2f& pos,
 		int nPoints,
 		float radius,
@@ -72,12 +77,34 @@ public:
 	 */
 	void setTexture(const std::string& path, bool activate = true);
 
+	/**
+	 * @brief Method which sets an already loaded texture of the polygon, so that it can be shared
+	 * between particles, and sets if it should become immedialty active.
+	 * @param texture The Texture reference.
+	 * @param activate Activates the texture.
+	 */
+	void setTexture(boost::shared_ptr<sf::Texture> texture, bool activate = true);
+
 	/**
 	 * @brief Method which enables the texture to be rendered over the shape background color.
 	 * @param enable The enable flag.
 	 */
 	void enableTexture(bool enable);
 
+	/**
+	 * @brief Method which gets the active texture of the polygon.
+	 * @return The Texture reference, nullptr if no texture is active.
+	 */
+	boost::shared_ptr<sf::Texture> getTexture() const;
+
+	/**
+	 * @brief Method which appends the polygon as triangles, in local coordinates (rotated and scaled but not positioned),
+	 * with its texture coordinates and fill color, to a vertex vector. Used to batch the rendering of many particles.
+	 * @param vertices The vector of vertices to be appended to.
+	 * @return The number of vertices appended.
+	 */
+	std::size_t appendLocalTriangles(std::vector<sf::Vertex>& vertices) const;
+
 	/**
 	 * @brief Method which randomizes the particle's texture background color.
 	 */
@@ -91,51 +118,24 @@ public:
 
 	/**
 	 * @brief Method which draws the rectangle shape to a specific window.
-	 * @param window The window object reference.
+	 * @param target The render target, a window or an offscreen texture.
 	 */
-	void drawTo(sf::RenderWindow* window) override;
-
-	/**
-	 * @brief Method which updates the internal state of the object
-	 * based on deltaTime.
-	 * @param deltaTime The time interval to update the differential equations.
-	 */
-	void updatePhysics(float deltaTime) override;
+	void drawTo(sf::RenderTarget* target) override;
 
 	void setRandomBirthStateParams(const sf::Vector2f& subWindowArea);
 
-	/**
-	 * @brief Method which sets the internal birth state of the object.
-	 * @param state The state to be born with.
-	 * @param timeOfBirth The time the objects is suposed to be born.
-	 */
-	void setBirthState(const State& state, float timeOfBirth = 0) override;
-
-	/**
-	 * @brief Method which sets the internal reset state of the object.
-	 * @param state The state to be reset with.
-	 */
-	void setResetState(const State& state) override;
-
 	/**
 	 * @brief Method which sets up a random birth state, and saves it to reset state.
 	 */
 	void setupRandomBirthState();
 
 	/**
-	 * @brief Method which implements a resetToBirthState behaviour.
+	 * @brief Static method which sets up random birth states for many particles at once, the random values being drawn in bulk,
+	 * and saves them to their reset states.
+	 * @param particles The particles.
+	 * @param subWindowArea The area the particles are born in.
 	 */
-	void resetToBirthState() override;
-
-	/**
-	 * @brief Method which implements a birth behaviour.
-	 */
-	void birth() override;
-
-	/**
-	 * @brief Method which implements a death behaviour.
-	 */
-	void death() override;
+	static void setupRandomBirthStates(const std::vector<boost::shared_ptr<PolyParticleShape>>& particles, const sf::Vector2f& subWindowArea);
 
 	/**
 	 * @brief Method which rotates the ConvexShape polygon shape.
@@ -169,12 +169,15 @@ private:
 	 */
 	void generatePolygon(int nPoints, float radius);
 
+	/**
+	 * @brief Static method which draws random birth states, in bulk.
+	 * @param subWindowArea The area the particles are born in.
+	 * @param count The number of birth states.
+	 * @param states The array of birth states to be filled.
+	 * @param timesOfBirth The array of times of birth to be filled.
+	 */
+	static void generateRandomBirthStates(const sf::Vector2f& subWindowArea, std::size_t count, State* states, float* timesOfBirth);
+
 	/** @brief Holds the birth Parameters of the particle. */
 	BirthParams m_birthParams;
-
-	/** @brief Holds a flag value, true if the particle is to be rendered. */
-	bool m_isVisible;
-
-	/** @brief Holds a flag value, true if birth sound has been played. */
-	bool m_birthSoundPlayed;
 };
\ No newline at end of file
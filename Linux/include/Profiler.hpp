@@ -0,0 +1,197 @@
+/*****************************************************************
+ * \file	Profiler.hpp
+ * \brief	Header is for class Profiler, to be used with Profiler.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/shared_array.hpp>
+#include <boost/shared_ptr.hpp>
+
+/**
+ * @brief Profiler class, singleton, records timed zones of every thread, to be exported as Chrome Trace Event JSON
+ * (viewable in chrome://tracing or Perfetto). Each thread records into its own ring buffer, without locks,
+ * and the oldest zones are overwritten once it is full. The capture is switched on and off at runtime,
+ * while it is off a zone costs a single relaxed load.
+ */
+class Profiler {
+public:
+
+	/**
+	 * @brief Zone class times its own scope, on the calling thread, while the capture is on.
+	 */
+	class Zone {
+	public:
+		/**
+		 * @brief Constructor, the zone begins.
+		 * @param name The name of the zone, it must outlive the profiler (a string literal).
+		 */
+		explicit Zone(const char* name) :
+			m_name(nullptr),
+			m_begin(0)
+		{
+			if (Profiler::isEnabled()) {
+				m_name = name;
+				m_begin = Profiler::getTime();
+			}
+		}
+
+		/**
+		 * @brief Destructor, the zone ends and is recorded.
+		 */
+		~Zone()
+		{
+			if (m_name != nullptr) {
+				Profiler::record(m_name, m_begin, Profiler::getTime());
+			}
+		}
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		/** @brief Holds the name of the zone, nullptr when the capture was off as it began. */
+		const char* m_name;
+
+		/** @brief Holds the time the zone began, in nanoseconds. */
+		std::int64_t m_begin;
+	};
+
+	/**
+	 * @brief Method which gets the instance of Profiler singleton.
+	 * @return The instance of the Profiler singleton.
+	 */
+	static Profiler& getInstance();
+
+	/**
+	 * @brief Method which switches the capture on or off.
+	 * @param enabled The value of true to capture.
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 * @brief Method which checks if the capture is on.
+	 * @return The value of true if it is on.
+	 */
+	static bool isEnabled()
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Method which names the calling thread on the trace.
+	 * @param name The name of the thread.
+	 */
+	static void setThreadName(const std::string& name);
+
+	/**
+	 * @brief Method which gets the time since the profiler started.
+	 * @return The time, in nanoseconds.
+	 */
+	static std::int64_t getTime();
+
+	/**
+	 * @brief Method which records a zone on the ring buffer of the calling thread.
+	 * @param name The name of the zone, it must outlive the profiler (a string literal).
+	 * @param begin The time the zone began, in nanoseconds.
+	 * @param end The time the zone ended, in nanoseconds.
+	 */
+	static void record(const char* name, std::int64_t begin, std::int64_t end);
+
+	/**
+	 * @brief Method which discards every zone recorded so far.
+	 */
+	static void clear();
+
+	/**
+	 * @brief Method which writes the zones recorded, of every thread, as Chrome Trace Event JSON.
+	 * It may be called while other threads record.
+	 * @param stream The output stream.
+	 * @return The number of zones written.
+	 */
+	static std::size_t writeChromeTrace(std::ostream& stream);
+
+	/**
+	 * @brief Method which writes the zones recorded to a Chrome Trace Event JSON file.
+	 * @param path The path of the file.
+	 * @return The number of zones written.
+	 */
+	static std::size_t saveChromeTrace(const std::string& path);
+
+private:
+	/**
+	 * @brief Number of zones each thread keeps, a power of 2.
+	 */
+	static const std::size_t ringCapacity = std::size_t(1) << 16;
+
+	/**
+	 * @brief Structure which holds a recorded zone. Its fields are atomic only so that they may be read while
+	 * being overwritten, exports discard the zones overwritten meanwhile.
+	 */
+	struct Event {
+		/** @brief Holds the name of the zone. */
+		std::atomic<const char*> name;
+		/** @brief Holds the time the zone began, in nanoseconds. */
+		std::atomic<std::int64_t> begin;
+		/** @brief Holds the time the zone ended, in nanoseconds. */
+		std::atomic<std::int64_t> end;
+	};
+
+	/**
+	 * @brief Structure which holds the ring buffer of a thread, written by its thread only.
+	 */
+	struct ThreadBuffer {
+		/** @brief Holds the zones, indexed by their sequence number modulo the capacity, allocated on the first zone. */
+		boost::shared_array<Event> events;
+		/** @brief Holds the sequence number of the next zone. */
+		std::atomic<std::uint64_t> head;
+		/** @brief Holds the sequence number of the first zone not cleared. */
+		std::atomic<std::uint64_t> first;
+		/** @brief Holds the id of the thread on the trace. */
+		std::size_t threadId;
+		/** @brief Holds the name of the thread on the trace. */
+		std::string threadName;
+
+		/**
+		 * @brief Constructor.
+		 * @param id The id of the thread on the trace.
+		 */
+		explicit ThreadBuffer(std::size_t id);
+	};
+
+	/**
+	 * @brief Default constructor (private).
+	 */
+	Profiler();
+
+	/**
+	 * @brief Default destructor (private).
+	 */
+	~Profiler() = default;
+
+	/**
+	 * @brief Method which gets the ring buffer of the calling thread, created on its first use.
+	 * @return The ring buffer.
+	 */
+	static ThreadBuffer& getThreadBuffer();
+
+	/** @brief Holds the flag value, true while the capture is on. */
+	static std::atomic<bool> s_enabled;
+
+	/** @brief Holds the ring buffers of every thread, they outlive their threads. */
+	std::vector<boost::shared_ptr<ThreadBuffer>> m_threadBuffers;
+
+	/** @brief Holds the mutex which guards the list of ring buffers and the thread names. */
+	std::mutex m_mutex;
+};
@@ -0,0 +1,139 @@
+/*****************************************************************
+ * \file	RandomEngine.hpp
+ * \brief	Header is for class RandomEngine, to be used with RandomEngine.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief RandomEngine class is a xoshiro256** pseudo random generator: 256 bits of state, a period of 2^256 - 1,
+ * and a handful of instructions per 64 bit value. It is seeded explicitly, and split into independent streams
+ * by jumping ahead: jump() skips 2^128 values (a stream per subsystem), longJump() skips 2^192 values (a stream per thread).
+ * It is not thread safe, each thread is to use its own engine, see getThreadEngine().
+ * It meets the UniformRandomBitGenerator requirements, so it can also drive the <random> distributions.
+ */
+class RandomEngine
+{
+public:
+	/**
+	 * @brief Type of the generated values.
+	 */
+	typedef std::uint64_t result_type;
+
+	/**
+	 * @brief Constructor, of the first stream of a seed.
+	 * @param seed The seed, expanded into the 256 bits of state.
+	 */
+	explicit RandomEngine(std::uint64_t seed = 0);
+
+	/**
+	 * @brief Constructor, of a subsystem stream of a seed, independent of the other streams of the same seed.
+	 * @param seed The seed, expanded into the 256 bits of state.
+	 * @param stream The stream number, the engine jumps ahead this many times, so it is meant to be small.
+	 */
+	RandomEngine(std::uint64_t seed, unsigned int stream);
+
+	/**
+	 * @brief Method which reseeds the engine, on its first stream.
+	 * @param seed The seed, expanded into the 256 bits of state.
+	 */
+	void seed(std::uint64_t seed);
+
+	/**
+	 * @brief Static method which gets the smallest value generated.
+	 * @return The smallest value.
+	 */
+	static constexpr result_type min() { return 0; }
+
+	/**
+	 * @brief Static method which gets the largest value generated.
+	 * @return The largest value.
+	 */
+	static constexpr result_type max() { return UINT64_MAX; }
+
+	/**
+	 * @brief Method which generates the next 64 bit value.
+	 * @return The value.
+	 */
+	result_type operator()();
+
+	/**
+	 * @brief Method which generates a float uniformly distributed in [0, 1), with the full 24 bit precision of a float.
+	 * @return The value.
+	 */
+	float nextFloat();
+
+	/**
+	 * @brief Method which generates a float uniformly distributed within an interval.
+	 * @param lowest The lower bound of the interval.
+	 * @param highest The higher bound of the interval.
+	 * @return The value.
+	 */
+	float uniform(float lowest, float highest);
+
+	/**
+	 * @brief Method which fills an array with floats uniformly distributed within an interval, in bulk.
+	 * @param values The array to be filled.
+	 * @param count The number of values.
+	 * @param lowest The lower bound of the interval.
+	 * @param highest The higher bound of the interval.
+	 */
+	void fillUniform(float* values, std::size_t count, float lowest, float highest);
+
+	/**
+	 * @brief Method which skips 2^128 values, i.e. moves to the next subsystem stream.
+	 */
+	void jump();
+
+	/**
+	 * @brief Method which skips 2^192 values, i.e. moves to the next thread stream.
+	 */
+	void longJump();
+
+	/**
+	 * @brief Method which gets the 256 bits of state, e.g. to be persisted, and restored with setState().
+	 * @param state The state.
+	 */
+	void getState(std::uint64_t(&state)[4]) const;
+
+	/**
+	 * @brief Method which restores a state got with getState(), the engine continues its sequence from there.
+	 * @param state The state, not all zeros.
+	 */
+	void setState(const std::uint64_t(&state)[4]);
+
+	/**
+	 * @brief Static method which sets the seed of the engines of every thread, they are reseeded on their next use.
+	 * @param seed The seed.
+	 */
+	static void setGlobalSeed(std::uint64_t seed);
+
+	/**
+	 * @brief Static method which gets the seed of the engines of every thread.
+	 * @return The seed.
+	 */
+	static std::uint64_t getGlobalSeed();
+
+	/**
+	 * @brief Static method which gets the engine of the calling thread, seeded with the global seed on its own thread stream.
+	 * Threads are given their stream in the order they first use it.
+	 * @return The engine of the calling thread.
+	 */
+	static RandomEngine& getThreadEngine();
+
+private:
+	/**
+	 * @brief Method which applies a jump polynomial to the state.
+	 * @param polynomial The jump polynomial.
+	 */
+	void applyJump(const std::uint64_t(&polynomial)[4]);
+
+	/** @brief Holds the 256 bits of state. */
+	std::uint64_t m_state[4];
+};
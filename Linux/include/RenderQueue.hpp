@@ -0,0 +1,136 @@
+/*****************************************************************
+ * \file	RenderQueue.hpp
+ * \brief	Header is for class RenderQueue, to be used with RenderQueue.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "WindowInterface.hpp"
+
+namespace sf {
+	class RenderTarget;
+	class Texture;
+}
+
+/**
+ * @brief RenderQueue class orders the draws of a window by layer and, within a layer, by texture, so that consecutive draws
+ * share their texture and the render target binds it once: each object is split into its draw passes (a box, then its text),
+ * and every pass of a layer is drawn before the next one. The order is kept from frame to frame, and repaired when a texture
+ * changes, so a frame costs one look up per draw. It counts the draw calls and texture binds of each frame.
+ */
+class RenderQueue
+{
+public:
+	/**
+	 * @brief Structure which holds the statistics of the draws.
+	 */
+	struct Stats {
+		/** @brief Holds the number of frames. */
+		std::size_t frames = 0;
+		/** @brief Holds the number of draw calls. */
+		std::size_t draws = 0;
+		/** @brief Holds the number of texture binds, each time a draw uses another texture than the previous one on its target. */
+		std::size_t binds = 0;
+	};
+
+	/**
+	 * @brief Default constructor.
+	 */
+	RenderQueue();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~RenderQueue() = default;
+
+	/**
+	 * @brief Method which adds the draw passes of an object.
+	 * @param child The object, its passes only cover what its own previous passes do.
+	 * @param layer The render layer of the object, lower layers are drawn first.
+	 */
+	void add(boost::shared_ptr<WindowInterface> child, int layer);
+
+	/**
+	 * @brief Method which begins a frame: updates the texture of every draw, sorts the draws, and resets the frame statistics.
+	 */
+	void beginFrame();
+
+	/**
+	 * @brief Method which draws the draw passes of a range of layers, in order.
+	 * @param target The render target, a window or an offscreen texture.
+	 * @param firstLayer The lowest layer drawn.
+	 * @param lastLayer The highest layer drawn.
+	 */
+	void draw(sf::RenderTarget* target, int firstLayer, int lastLayer);
+
+	/**
+	 * @brief Method which counts a draw made outside the queue, in the current frame.
+	 * @param target The render target.
+	 * @param texture The texture the draw uses, nullptr if none.
+	 */
+	void recordDraw(sf::RenderTarget* target, const sf::Texture* texture);
+
+	/**
+	 * @brief Method which gets the statistics of the current frame, or of the last one, between frames.
+	 * @return The statistics.
+	 */
+	const Stats& getFrameStats() const;
+
+	/**
+	 * @brief Method which gets the statistics of every frame.
+	 * @return The statistics.
+	 */
+	const Stats& getTotalStats() const;
+
+private:
+	/**
+	 * @brief Structure which holds a draw pass of an object.
+	 */
+	struct Draw {
+		/** @brief Holds the object (not the owner). */
+		boost::shared_ptr<WindowInterface> child;
+		/** @brief Holds the render layer of the object. */
+		int layer;
+		/** @brief Holds the draw pass of the object. */
+		std::size_t pass;
+		/** @brief Holds the texture of the draw pass, as of the beginning of the frame. */
+		const sf::Texture* texture;
+		/** @brief Holds the number of the draw, in order of addition, to break ties. */
+		std::uint64_t sequence;
+	};
+
+	/**
+	 * @brief Static method which compares the order of two draws.
+	 * @param a The first draw.
+	 * @param b The second draw.
+	 * @return The value of true if a is drawn before b.
+	 */
+	static bool isBefore(const Draw& a, const Draw& b);
+
+	/** @brief Holds the draws, in order. */
+	std::vector<Draw> m_draws;
+
+	/** @brief Holds the number of the next draw added. */
+	std::uint64_t m_nextSequence;
+
+	/** @brief Holds the target of the last draw, nullptr at the beginning of a frame. */
+	sf::RenderTarget* m_lastTarget;
+
+	/** @brief Holds the texture of the last draw. */
+	const sf::Texture* m_lastTexture;
+
+	/** @brief Holds the statistics of the current frame. */
+	Stats m_frameStats;
+
+	/** @brief Holds the statistics of every frame. */
+	Stats m_totalStats;
+};
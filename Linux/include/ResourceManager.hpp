@@ -0,0 +1,136 @@
+/*****************************************************************
+ * \file	ResourceManager.hpp
+ * \brief	Header is for class ResourceManager, to be used with ResourceManager.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <set>
+#include <cstddef>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace sf {
+	class Texture;
+	class SoundBuffer;
+	class Font;
+}
+
+/**
+ * @brief ResourceManager class, singleton, decodes each resource file only once and hands out
+ * shared (reference counted) handles to it. A resource is released once no handle references it,
+ * and is decoded again if it is requested after that.
+ */
+class ResourceManager {
+public:
+
+	/**
+	 * @brief Structure which holds the usage statistics of a resource cache.
+	 */
+	struct Stats {
+		/** @brief Holds the number of requests served from the cache. */
+		std::size_t hits = 0;
+		/** @brief Holds the number of requests which had to decode the resource. */
+		std::size_t misses = 0;
+		/** @brief Holds the number of resources currently alive. */
+		std::size_t resident = 0;
+		/** @brief Holds the (estimated) number of bytes of the resources currently alive. */
+		std::size_t bytesResident = 0;
+		/** @brief Holds the number of glyph pages (atlas textures) of the fonts currently alive, fonts only. */
+		std::size_t glyphPages = 0;
+	};
+
+	/**
+	 * @brief Method which gets the instance of ResourceManager singleton.
+	 * @return The instance of the ResourceManager singleton.
+	 */
+	static ResourceManager& getInstance();
+
+	/**
+	 * @brief Method which gets a texture, it is loaded from file only if it isn't already alive.
+	 * @param path The path of the texture file.
+	 * @return The shared Texture reference.
+	 */
+	static boost::shared_ptr<sf::Texture> getTexture(const std::string& path);
+
+	/**
+	 * @brief Method which gets the usage statistics of the texture cache.
+	 * @return The texture cache statistics.
+	 */
+	static Stats getTextureStats();
+
+	/**
+	 * @brief Method which gets a sound buffer (a short clip fully decoded in memory),
+	 * it is loaded from file only if it isn't already alive.
+	 * @param path The path of the sound file.
+	 * @return The shared SoundBuffer reference.
+	 */
+	static boost::shared_ptr<sf::SoundBuffer> getSoundBuffer(const std::string& path);
+
+	/**
+	 * @brief Method which gets the usage statistics of the sound buffer cache.
+	 * @return The sound buffer cache statistics.
+	 */
+	static Stats getSoundBufferStats();
+
+	/**
+	 * @brief Method which gets a font, it is loaded from file only if it isn't already alive.
+	 * Widgets sharing a font also share its glyph pages (one atlas texture per character size).
+	 * @param path The path of the font file.
+	 * @param characterSize The character size the caller will render with, to be accounted on the statistics (0 if unknown).
+	 * @return The shared Font reference.
+	 */
+	static boost::shared_ptr<sf::Font> getFont(const std::string& path, unsigned int characterSize = 0);
+
+	/**
+	 * @brief Method which gets the usage statistics of the font cache,
+	 * the resident bytes are the bytes of the glyph pages of the character sizes in use.
+	 * @return The font cache statistics.
+	 */
+	static Stats getFontStats();
+
+private:
+	/**
+	 * @brief Default constructor.
+	 */
+	ResourceManager();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~ResourceManager() = default;
+
+	/** @brief Holds the map of (non owning) Texture references, one for each loaded path. */
+	std::map<std::string, boost::weak_ptr<sf::Texture>> m_textureMap;
+
+	/** @brief Holds the texture cache statistics (resident values are computed on request). */
+	Stats m_textureStats;
+
+	/** @brief Holds the map of (non owning) SoundBuffer references, one for each loaded path. */
+	std::map<std::string, boost::weak_ptr<sf::SoundBuffer>> m_soundBufferMap;
+
+	/** @brief Holds the sound buffer cache statistics (resident values are computed on request). */
+	Stats m_soundBufferStats;
+
+	/**
+	 * @brief Structure which holds a cached font.
+	 */
+	struct FontEntry {
+		/** @brief Holds the (non owning) Font reference. */
+		boost::weak_ptr<sf::Font> font;
+		/** @brief Holds the character sizes the font is rendered with, one glyph page each. */
+		std::set<unsigned int> characterSizes;
+	};
+
+	/** @brief Holds the map of cached fonts, one for each loaded path. */
+	std::map<std::string, FontEntry> m_fontMap;
+
+	/** @brief Holds the font cache statistics (resident values are computed on request). */
+	Stats m_fontStats;
+};
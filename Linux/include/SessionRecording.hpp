@@ -0,0 +1,176 @@
+/*****************************************************************
+ * \file	SessionRecording.hpp
+ * \brief	Header is for class SessionRecording, to be used with SessionRecording.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <SFML/Window/Event.hpp>
+
+/**
+ * @brief SessionRecording class records a session of the game to a compact binary file, or replays one from it:
+ * what it starts from (random seed, physics step, kinematics and credit counters), then, for every frame,
+ * its measured time and the window events the game saw during it, and what it ended with (counters and a checksum
+ * of the simulation). Replaying the frame times and the events from the same start reproduces the same steps,
+ * so the same particle trajectories and counters, whatever the speed it is replayed at.
+ * Only the window events the game reacts to are recorded (focus, resize, keys and mouse).
+ */
+class SessionRecording
+{
+public:
+	/**
+	 * @brief Structure which holds what a session starts from.
+	 */
+	struct Header {
+		/** @brief Holds the seed of the random generators. */
+		std::uint64_t seed = 0;
+		/** @brief Holds the fixed physics step, in seconds. */
+		float stepTime = 0;
+		/** @brief Holds the kinematics of the particles, a ParticleSystem::Kinematics. */
+		std::uint32_t kinematics = 0;
+		/** @brief Holds the play count. */
+		std::uint32_t playCount = 0;
+		/** @brief Holds the inserted plays count. */
+		std::uint32_t insertCount = 0;
+		/** @brief Holds the removed plays count. */
+		std::uint32_t removeCount = 0;
+	};
+
+	/**
+	 * @brief Structure which holds what a session ended with.
+	 */
+	struct Result {
+		/** @brief Holds the number of frames. */
+		std::uint64_t frames = 0;
+		/** @brief Holds the play count. */
+		std::uint32_t playCount = 0;
+		/** @brief Holds the inserted plays count. */
+		std::uint32_t insertCount = 0;
+		/** @brief Holds the removed plays count. */
+		std::uint32_t removeCount = 0;
+		/** @brief Holds the checksum of the simulation (game state and particles). */
+		std::uint32_t checksum = 0;
+
+		/**
+		 * @brief Method which compares two results.
+		 * @param other The other result.
+		 * @return The value of true if they are the same.
+		 */
+		bool operator==(const Result& other) const;
+	};
+
+	/**
+	 * @brief Constructor, of a recording: creates the file and writes what the session starts from.
+	 * @param path The path of the file.
+	 * @param header What the session starts from.
+	 */
+	SessionRecording(const std::string& path, const Header& header);
+
+	/**
+	 * @brief Constructor, of a replay: loads the file.
+	 * @param path The path of the file.
+	 */
+	explicit SessionRecording(const std::string& path);
+
+	/**
+	 * @brief Destructor, closes the file of a recording (ended or not).
+	 */
+	~SessionRecording();
+
+	SessionRecording(const SessionRecording&) = delete;
+	SessionRecording& operator=(const SessionRecording&) = delete;
+
+	/**
+	 * @brief Method which checks if it replays a session.
+	 * @return The value of true if it replays, false if it records.
+	 */
+	bool isReplaying() const;
+
+	/**
+	 * @brief Method which gets what the session starts from.
+	 * @return The header.
+	 */
+	const Header& getHeader() const;
+
+	/**
+	 * @brief Method which records the start of a frame, recording.
+	 * @param frameTime The time of the frame, as accumulated by the game loop, in seconds.
+	 */
+	void recordFrame(float frameTime);
+
+	/**
+	 * @brief Method which records a window event, of the current frame, recording. The events not recorded are ignored.
+	 * @param evnt The event.
+	 */
+	void recordEvent(const sf::Event& evnt);
+
+	/**
+	 * @brief Method which records what the session ended with, and closes the file, recording.
+	 * @param result What the session ended with, its number of frames is the one recorded.
+	 */
+	void recordEnd(const Result& result);
+
+	/**
+	 * @brief Method which replays the next frame.
+	 * @param frameTime The time of the frame, in seconds.
+	 * @param events The window events of the frame, replaced.
+	 * @return The value of true if there was one, false once every frame was replayed.
+	 */
+	bool replayFrame(float& frameTime, std::vector<sf::Event>& events);
+
+	/**
+	 * @brief Method which gets what the replayed session ended with.
+	 * @param result What the session ended with.
+	 * @return The value of true if it was recorded, false if the recording was interrupted.
+	 */
+	bool getRecordedResult(Result& result) const;
+
+private:
+	/**
+	 * @brief Method which writes bytes to the file, recording.
+	 * @param data The bytes.
+	 * @param size The number of bytes.
+	 */
+	void write(const void* data, std::size_t size);
+
+	/**
+	 * @brief Method which reads bytes from the loaded file, replaying.
+	 * @param data The bytes.
+	 * @param size The number of bytes.
+	 * @return The value of true if there were enough.
+	 */
+	bool read(void* data, std::size_t size);
+
+	/** @brief Holds the flag value, true if it replays. */
+	bool m_replaying;
+
+	/** @brief Holds what the session starts from. */
+	Header m_header;
+
+	/** @brief Holds the file, recording. */
+	std::ofstream m_file;
+
+	/** @brief Holds the bytes of the file, after the header, replaying. */
+	std::vector<unsigned char> m_data;
+
+	/** @brief Holds the position of the next record on the bytes of the file, replaying. */
+	std::size_t m_position;
+
+	/** @brief Holds the number of frames recorded, recording. */
+	std::uint64_t m_frames;
+
+	/** @brief Holds the flag value, true if the session end was recorded (recording), or read (replaying). */
+	bool m_ended;
+
+	/** @brief Holds what the replayed session ended with. */
+	Result m_result;
+};
@@ -0,0 +1,203 @@
+/*****************************************************************
+ * \file	SnapshotFile.hpp
+ * \brief	Header is for class SnapshotFile, to be used with SnapshotFile.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief SnapshotFile class keeps the latest snapshot of a block of bytes in a preallocated, memory mapped file,
+ * double buffered: each snapshot is written into the slot not holding the previous one, checksummed and numbered,
+ * so a snapshot torn by a power loss leaves the previous one whole. Writing is a copy into the mapping;
+ * a dedicated thread syncs the written slot to disk, and no slot is written before the previous snapshot is synced,
+ * so there is always a whole snapshot on disk. A snapshot written meanwhile goes to a pending buffer, replacing
+ * the one pending before it, and the sync thread moves it to the free slot once the sync ends.
+ */
+class SnapshotFile
+{
+public:
+	/**
+	 * @brief Structure which holds the statistics of the snapshots.
+	 */
+	struct Stats {
+		/** @brief Holds the number of snapshots written. */
+		std::size_t written = 0;
+		/** @brief Holds the number of pending snapshots replaced by a newer one, while a slot was being synced. */
+		std::size_t coalesced = 0;
+		/** @brief Holds the number of slots synced to disk. */
+		std::size_t synced = 0;
+		/** @brief Holds the time spent writing the snapshots (copy and checksum), in seconds. */
+		double writeTime = 0;
+		/** @brief Holds the longest time spent writing a snapshot, in seconds. */
+		double maxWriteTime = 0;
+		/** @brief Holds the time spent syncing slots, on the sync thread, in seconds. */
+		double syncTime = 0;
+
+		/**
+		 * @brief Method which gets the average time of writing a snapshot.
+		 * @return The average time, in seconds.
+		 */
+		double getAverageWriteTime() const;
+	};
+
+	/**
+	 * @brief Constructor, maps the file (created, or resized and emptied if it doesn't fit the capacity)
+	 * and starts the sync thread.
+	 * @param path The path of the file.
+	 * @param capacity The largest snapshot, in bytes.
+	 */
+	SnapshotFile(const std::string& path, std::size_t capacity);
+
+	/**
+	 * @brief Destructor, waits for the slots being synced, unmaps the file and stops the sync thread.
+	 */
+	~SnapshotFile();
+
+	SnapshotFile(const SnapshotFile&) = delete;
+	SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+	/**
+	 * @brief Method which gets the latest whole snapshot found on the file when it was mapped.
+	 * @param data The bytes of the snapshot.
+	 * @return The value of true if there was one.
+	 */
+	bool getRecoveredSnapshot(std::vector<unsigned char>& data) const;
+
+	/**
+	 * @brief Method which begins writing a snapshot, into the free slot, or the pending buffer while a slot is being synced.
+	 * @return The block of capacity bytes to be written.
+	 */
+	unsigned char* beginWrite();
+
+	/**
+	 * @brief Method which ends writing a snapshot begun with beginWrite(), and hands it to the sync thread.
+	 * @param size The number of bytes written.
+	 */
+	void endWrite(std::size_t size);
+
+	/**
+	 * @brief Method which gets the statistics of the snapshots.
+	 * @return The statistics.
+	 */
+	Stats getStats() const;
+
+private:
+	/**
+	 * @brief Structure which holds the header of a slot, as mapped.
+	 */
+	struct SlotHeader {
+		/** @brief Holds the magic number of the file format. */
+		std::uint32_t magic;
+		/** @brief Holds the number of bytes of the snapshot. */
+		std::uint32_t size;
+		/** @brief Holds the number of the snapshot, increasing, 0 if the slot is empty. */
+		std::uint64_t generation;
+		/** @brief Holds the CRC-32 of the size, generation and snapshot bytes. */
+		std::uint32_t checksum;
+		/** @brief Holds padding, to keep the snapshot bytes aligned. */
+		std::uint32_t reserved;
+	};
+
+	/**
+	 * @brief Method which gets the header of a slot, on the mapping.
+	 * @param slot The slot, 0 or 1.
+	 * @return The header.
+	 */
+	SlotHeader* getSlotHeader(int slot) const;
+
+	/**
+	 * @brief Method which checks a slot, on the mapping.
+	 * @param slot The slot, 0 or 1.
+	 * @return The value of true if it holds a whole snapshot.
+	 */
+	bool isSlotValid(int slot) const;
+
+	/**
+	 * @brief Static method which computes the checksum of a slot.
+	 * @param header The header of the slot, followed by its snapshot bytes.
+	 * @return The checksum.
+	 */
+	static std::uint32_t computeChecksum(const SlotHeader* header);
+
+	/**
+	 * @brief Method which numbers and checksums the snapshot written in a slot, and hands the slot to the sync thread,
+	 * with \pm_mutex locked.
+	 * @param slot The slot, 0 or 1.
+	 * @param size The number of bytes written.
+	 */
+	void publishSlot(int slot, std::size_t size);
+
+	/**
+	 * @brief Method which syncs the slots handed to it to disk, until the file is destroyed, on the sync thread.
+	 */
+	void syncLoop();
+
+	/** @brief Holds the largest snapshot, in bytes. */
+	std::size_t m_capacity;
+
+	/** @brief Holds the size of a slot, a whole number of pages. */
+	std::size_t m_slotSize;
+
+	/** @brief Holds the file descriptor. */
+	int m_file;
+
+	/** @brief Holds the mapping of the file, both slots. */
+	unsigned char* m_mapping;
+
+	/** @brief Holds the latest whole snapshot found when the file was mapped. */
+	std::vector<unsigned char> m_recoveredSnapshot;
+
+	/** @brief Holds the flag value, true if a snapshot was found when the file was mapped. */
+	bool m_recovered;
+
+	/** @brief Holds the number of the last snapshot written. */
+	std::uint64_t m_generation;
+
+	/** @brief Holds the slot of the last snapshot written, -1 if none. */
+	int m_lastSlot;
+
+	/** @brief Holds the slot being written, -1 if none, 2 if the pending buffer. */
+	int m_writingSlot;
+
+	/** @brief Holds the time the snapshot being written began. */
+	std::chrono::steady_clock::time_point m_writeStart;
+
+	/** @brief Holds the flag values, true while a slot is handed to the sync thread, and not synced yet. */
+	bool m_syncing[2];
+
+	/** @brief Holds the snapshot written while a slot was being synced, capacity bytes. */
+	std::vector<unsigned char> m_pendingSnapshot;
+
+	/** @brief Holds the number of bytes of the pending snapshot. */
+	std::size_t m_pendingSize;
+
+	/** @brief Holds the flag value, true if the pending snapshot is whole, and not moved to a slot yet. */
+	bool m_hasPending;
+
+	/** @brief Holds the flag value, true while the sync thread is to stop. */
+	bool m_stopping;
+
+	/** @brief Holds the statistics. */
+	Stats m_stats;
+
+	/** @brief Holds the mutex which guards the slots, the pending snapshot, the sync flags and the statistics. */
+	mutable std::mutex m_mutex;
+
+	/** @brief Holds the condition the sync thread, and the destructor waiting for it, are woken with. */
+	std::condition_variable m_syncCondition;
+
+	/** @brief Holds the sync thread. */
+	std::thread m_syncThread;
+};
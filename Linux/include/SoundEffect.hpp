@@ -0,0 +1,61 @@
+/*****************************************************************
+ * \file	SoundEffect.hpp
+ * \brief	Header is for class SoundEffect, to be used with SoundEffect.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "SoundPool.hpp"
+
+/**
+ * @brief SoundEffect class is a light handle to a short sound clip: the clip is decoded once,
+ * shared through the ResourceManager, and played on the voices of the SoundPool.
+ */
+class SoundEffect
+{
+public:
+
+	/**
+	 * @brief Constructor.
+	 * @param path The path of the sound to be loaded.
+	 * @param priority The priority of the sound, when competing for a voice.
+	 */
+	SoundEffect(const std::string& path, SoundPool::Priority priority = SoundPool::Normal);
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~SoundEffect() = default;
+
+	/**
+	 * @brief Method which plays the sound, overlapping the previous plays if they are still playing.
+	 */
+	void play();
+
+	/**
+	 * @brief Method which plays the sound only once, until it has finished.
+	 */
+	void uninterruptedPlay();
+
+	/**
+	 * @brief Method which stops the last play of the sound.
+	 */
+	void stop();
+
+private:
+	/** @brief Holds the shared SoundBuffer reference. */
+	boost::shared_ptr<sf::SoundBuffer> m_buffer;
+
+	/** @brief Holds the priority of the sound. */
+	SoundPool::Priority m_priority;
+
+	/** @brief Holds the identifier of the last play of the sound. */
+	SoundPool::VoiceId m_lastVoice;
+};
@@ -0,0 +1,136 @@
+/*****************************************************************
+ * \file	SoundPool.hpp
+ * \brief	Header is for class SoundPool, to be used with SoundPool.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <SFML/Audio.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+/**
+ * @brief SoundPool class, singleton, plays the short sound effects through a bounded number of voices.
+ * When every voice is busy, a new sound steals the voice of the lowest priority (and oldest) sound,
+ * if that priority isn't higher than its own, otherwise the new sound is dropped.
+ * Long sounds, like the music loop, are streamed with CustomSound instead.
+ */
+class SoundPool {
+public:
+
+	/**
+	 * @brief Type which identifies the priority of a sound effect.
+	 */
+	enum Priority {
+		Low,
+		Normal,
+		High
+	};
+
+	/**
+	 * @brief Type which identifies a played sound, 0 if it wasn't played.
+	 */
+	typedef unsigned long long VoiceId;
+
+	/**
+	 * @brief Structure which holds the usage statistics of the pool.
+	 */
+	struct Stats {
+		/** @brief Holds the number of voices of the pool. */
+		std::size_t voices = 0;
+		/** @brief Holds the number of voices currently playing. */
+		std::size_t playing = 0;
+		/** @brief Holds the number of sounds played. */
+		std::size_t played = 0;
+		/** @brief Holds the number of sounds which stole a busy voice. */
+		std::size_t stolen = 0;
+		/** @brief Holds the number of sounds dropped, because every voice had a higher priority. */
+		std::size_t dropped = 0;
+	};
+
+	/**
+	 * @brief Method which gets the instance of SoundPool singleton.
+	 * @return The instance of the SoundPool singleton.
+	 */
+	static SoundPool& getInstance();
+
+	/**
+	 * @brief Method which sets the number of voices of the pool, stopping every sound being played.
+	 * @param voices The number of voices.
+	 */
+	static void setVoiceCount(std::size_t voices);
+
+	/**
+	 * @brief Method which plays a sound buffer on a free (or stolen) voice.
+	 * @param buffer The sound buffer to be played.
+	 * @param priority The priority of the sound.
+	 * @return The identifier of the played sound, 0 if it was dropped.
+	 */
+	static VoiceId play(boost::shared_ptr<sf::SoundBuffer> buffer, Priority priority = Normal);
+
+	/**
+	 * @brief Method which checks if a played sound is still playing.
+	 * @param voiceId The identifier of the played sound.
+	 * @return The value of true if it is still playing.
+	 */
+	static bool isPlaying(VoiceId voiceId);
+
+	/**
+	 * @brief Method which stops a played sound, if it is still playing.
+	 * @param voiceId The identifier of the played sound.
+	 */
+	static void stop(VoiceId voiceId);
+
+	/**
+	 * @brief Method which gets the usage statistics of the pool.
+	 * @return The pool statistics.
+	 */
+	static Stats getStats();
+
+private:
+	/**
+	 * @brief Structure which holds a voice of the pool.
+	 */
+	struct Voice {
+		/** @brief Holds the buffer being played, so it stays alive while it plays (declared before, destroyed after the sound). */
+		boost::shared_ptr<sf::SoundBuffer> buffer;
+		/** @brief Holds the sound source of the voice. */
+		sf::Sound sound;
+		/** @brief Holds the priority of the sound being played. */
+		Priority priority = Low;
+		/** @brief Holds the identifier of the sound being played. */
+		VoiceId id = 0;
+	};
+
+	/**
+	 * @brief Default constructor.
+	 */
+	SoundPool();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~SoundPool() = default;
+
+	/**
+	 * @brief Method which finds the voice playing a sound.
+	 * @param voiceId The identifier of the played sound.
+	 * @return The voice, nullptr if it is no longer on any voice.
+	 */
+	Voice* findVoice(VoiceId voiceId);
+
+	/** @brief Holds the voices of the pool. */
+	std::vector<Voice> m_voices;
+
+	/** @brief Holds the identifier of the next sound to be played (increasing, so it also gives the age). */
+	VoiceId m_nextId;
+
+	/** @brief Holds the pool statistics. */
+	Stats m_stats;
+};
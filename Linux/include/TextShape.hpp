@@ -11,7 +11,7 @@
 #include "BoxShape.hpp"
 #include <boost/shared_ptr.hpp>
 
-class CustomSound;
+class SoundEffect;
 
 /**
  * @brief TextShape class purpose is to initilize BoxShapes with texts within
@@ -44,7 +44,7 @@ public:
 	~TextShape() = default;
 
 	/**
-	 * @brief Method which resets the text font by loading another
+	 * @brief Method which resets the text font by loading another, fonts are shared between shapes.
 	 * @param path The path of the font to be loaded.
 	 */
 	void resetFont(const std::string& path);
@@ -76,20 +76,43 @@ public:
 
 	/**
 	 * @brief Method which draws the text object,and its compositors to the window.
-	 * @param window The window object reference.
+	 * @param target The render target, a window or an offscreen texture.
 	 * @see WindowInterface
 	 */
-	virtual void drawTo(sf::RenderWindow* window) override;
+	virtual void drawTo(sf::RenderTarget* target) override;
+
+	/**
+	 * @brief Method which gets the number of draw passes: the rectangle, then the text over it.
+	 * @return The number of passes.
+	 * @see WindowInterface
+	 */
+	virtual std::size_t getDrawPassCount() const override;
+
+	/**
+	 * @brief Method which gets the texture a draw pass uses.
+	 * @param pass The draw pass, 0 for the rectangle, 1 for the text.
+	 * @return The texture of the rectangle, or the glyph texture of the font, nullptr if none.
+	 * @see WindowInterface
+	 */
+	virtual const sf::Texture* getDrawPassTexture(std::size_t pass) const override;
+
+	/**
+	 * @brief Method which draws a draw pass to a specific render target.
+	 * @param target The render target, a window or an offscreen texture.
+	 * @param pass The draw pass, 0 for the rectangle, 1 for the text.
+	 * @see WindowInterface
+	 */
+	virtual void drawPassTo(sf::RenderTarget* target, std::size_t pass) override;
 
 protected:
 	/** @brief Holds the composing Text object. */
 	sf::Text p_text;
 
-	/** @brief Holds the composing Font object. */
-	sf::Font p_font;
+	/** @brief Holds the shared Font reference. */
+	boost::shared_ptr<sf::Font> p_font;
 
-	/** @brief Holds the CustomSound reference for the text update sound, if it is allocated. */
-	boost::shared_ptr<CustomSound> p_updateSound;
+	/** @brief Holds the SoundEffect reference for the text update sound, if it is allocated. */
+	boost::shared_ptr<SoundEffect> p_updateSound;
 
 	/** @brief Holds the flag value, true if the text update sound is active. */
 	bool p_updateTextSoundActive;
@@ -0,0 +1,96 @@
+/*****************************************************************
+ * \file	ThreadTimer.hpp
+ * \brief	Header is for class ThreadTimer, to be used with ThreadTimer.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief ThreadTimer class measures how busy a thread is: the time spent between begin() and end(),
+ * against the wall time since the first begin(). It is written by its own thread,
+ * and its statistics may be read from any other thread.
+ */
+class ThreadTimer
+{
+public:
+	/**
+	 * @brief Type of the clock the timer measures time with.
+	 */
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * @brief Structure which holds the timing statistics of a thread.
+	 */
+	struct Stats {
+		/** @brief Holds the number of timed iterations. */
+		std::size_t iterations = 0;
+		/** @brief Holds the time spent on the timed iterations, in seconds. */
+		double busyTime = 0;
+		/** @brief Holds the wall time since the first iteration began, in seconds. */
+		double wallTime = 0;
+
+		/**
+		 * @brief Method which gets the fraction of the wall time the thread was busy.
+		 * @return The busy fraction, between 0 and 1.
+		 */
+		double getUtilization() const;
+
+		/**
+		 * @brief Method which gets the average time of an iteration.
+		 * @return The average iteration time, in seconds.
+		 */
+		double getAverageTime() const;
+	};
+
+	/**
+	 * @brief Default constructor.
+	 */
+	ThreadTimer();
+
+	/**
+	 * @brief Default destructor.
+	 */
+	~ThreadTimer() = default;
+
+	/**
+	 * @brief Method which marks the beginning of a busy iteration.
+	 */
+	void begin();
+
+	/**
+	 * @brief Method which marks the end of a busy iteration.
+	 */
+	void end();
+
+	/**
+	 * @brief Method which gets the timing statistics, from any thread.
+	 * @return The statistics.
+	 */
+	Stats getStats() const;
+
+private:
+	/** @brief Holds the time the first iteration began. */
+	Clock::time_point m_start;
+
+	/** @brief Holds the time the current iteration began. */
+	Clock::time_point m_iterationStart;
+
+	/** @brief Holds the flag value, true once the first iteration began. */
+	std::atomic<bool> m_started;
+
+	/** @brief Holds the number of timed iterations. */
+	std::atomic<std::size_t> m_iterations;
+
+	/** @brief Holds the time spent on the timed iterations, in nanoseconds. */
+	std::atomic<long long> m_busyNanoseconds;
+
+	/** @brief Holds the wall time until the end of the last iteration, in nanoseconds. */
+	std::atomic<long long> m_wallNanoseconds;
+};
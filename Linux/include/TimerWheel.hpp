@@ -0,0 +1,205 @@
+/*****************************************************************
+ * \file	TimerWheel.hpp
+ * \brief	Header is for class TimerWheel, to be used with TimerWheel.cpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Delegate.hpp"
+
+/**
+ * @brief TimerWheel class schedules timed events (births, deaths, sounds, ...) on a clock of its own, advanced by its owner,
+ * as a hierarchical timer wheel: 4 levels of 64 slots, each slot a list of timers, the first level one tick per slot,
+ * each next level 64 times coarser. Scheduling and cancelling are constant time, and advancing the clock costs one slot
+ * per tick elapsed plus the timers fired, and the ones moved down a level once every 64 ticks of the level above:
+ * the work is proportional to the events that fire, not to the events pending.
+ * Timers fire once their exact time is reached, not rounded to a tick. Not thread safe, it belongs to the thread advancing it.
+ */
+class TimerWheel
+{
+public:
+	/**
+	 * @brief Type which identifies a scheduled timer, 0 if none.
+	 */
+	typedef std::uint64_t TimerId;
+
+	/**
+	 * @brief Structure which holds the statistics of the wheel.
+	 */
+	struct Stats {
+		/** @brief Holds the number of timers scheduled. */
+		std::size_t scheduled = 0;
+		/** @brief Holds the number of timers fired. */
+		std::size_t fired = 0;
+		/** @brief Holds the number of timers cancelled before firing. */
+		std::size_t cancelled = 0;
+		/** @brief Holds the number of timers moved down a level. */
+		std::size_t cascaded = 0;
+	};
+
+	/**
+	 * @brief Constructor, the clock starts at 0.
+	 * @param tickTime The time of a tick, the resolution of the first level, in seconds.
+	 */
+	explicit TimerWheel(double tickTime = 0.001);
+
+	/**
+	 * @brief Method which schedules a timer.
+	 * @param time The time the timer fires at, on the clock of the wheel, in seconds. A time already past fires on the next advance,
+	 * or within the current one, if it is scheduled by a callback.
+	 * @param callback The callback called when the timer fires, it may schedule and cancel timers.
+	 * @return The identifier of the timer.
+	 */
+	TimerId schedule(double time, const Delegate<void()>& callback);
+
+	/**
+	 * @brief Method which cancels a timer, if it didn't fire yet.
+	 * @param timerId The identifier of the timer.
+	 * @return The value of true if it was pending.
+	 */
+	bool cancel(TimerId timerId);
+
+	/**
+	 * @brief Method which advances the clock, and fires every timer due, in order of time (then in the order they were scheduled).
+	 * @param time The new time of the clock, in seconds, not before the current one.
+	 */
+	void advance(double time);
+
+	/**
+	 * @brief Method which drops every pending timer, without firing them, and sets the clock. Not to be called by a callback.
+	 * @param time The new time of the clock, in seconds.
+	 */
+	void reset(double time);
+
+	/**
+	 * @brief Method which gets the time of the clock.
+	 * @return The time, in seconds.
+	 */
+	double getTime() const;
+
+	/**
+	 * @brief Method which gets the number of pending timers.
+	 * @return The number of timers.
+	 */
+	std::size_t getPendingCount() const;
+
+	/**
+	 * @brief Method which gets the statistics of the wheel.
+	 * @return The statistics.
+	 */
+	const Stats& getStats() const;
+
+private:
+	/** @brief Number of bits of the slot index, on every level. */
+	static const unsigned slotBits = 6;
+
+	/** @brief Number of slots of each level. */
+	static const std::uint32_t slotCount = 1u << slotBits;
+
+	/** @brief Number of levels. */
+	static const unsigned levelCount = 4;
+
+	/** @brief Index of no timer, on the lists, and slot of the timers not pending. */
+	static const std::uint32_t none = 0xffffffffu;
+
+	/** @brief Slot of the timers taken from their slot to be fired. */
+	static const std::uint32_t firing = 0xfffffffeu;
+
+	/**
+	 * @brief Structure which holds a timer, on the pool.
+	 */
+	struct Timer {
+		/** @brief Holds the time the timer fires at, in seconds. */
+		double time;
+		/** @brief Holds the tick the timer fires on. */
+		std::uint64_t tick;
+		/** @brief Holds the number of the timer, in order of scheduling. */
+		std::uint64_t sequence;
+		/** @brief Holds the callback. */
+		Delegate<void()> callback;
+		/** @brief Holds the previous timer on its slot list, or none. */
+		std::uint32_t previous;
+		/** @brief Holds the next timer on its slot list (or on the free list), or none. */
+		std::uint32_t next;
+		/** @brief Holds the slot the timer is listed on (level * slotCount + index), firing if it is being fired, or none if it isn't pending. */
+		std::uint32_t slot;
+		/** @brief Holds the generation of the pool entry, incremented when it is freed, so stale identifiers are ignored. */
+		std::uint32_t generation;
+	};
+
+	/**
+	 * @brief Method which gets the tick a time falls in.
+	 * @param time The time, in seconds.
+	 * @return The tick.
+	 */
+	std::uint64_t getTick(double time) const;
+
+	/**
+	 * @brief Method which lists a timer on the slot of its tick, relative to the current tick.
+	 * @param index The index of the timer on the pool.
+	 */
+	void insert(std::uint32_t index);
+
+	/**
+	 * @brief Method which unlists a timer from its slot.
+	 * @param index The index of the timer on the pool.
+	 */
+	void unlink(std::uint32_t index);
+
+	/**
+	 * @brief Method which returns a timer to the free list.
+	 * @param index The index of the timer on the pool.
+	 */
+	void release(std::uint32_t index);
+
+	/**
+	 * @brief Method which moves every timer of a slot of a level down to the levels below, as the current tick reaches it.
+	 * @param level The level, above the first.
+	 */
+	void cascade(unsigned level);
+
+	/**
+	 * @brief Method which fires the timers of the current tick, on the first level: every one if the clock is advanced past the tick,
+	 * otherwise the ones due at the time it is advanced to.
+	 * @param time The time the clock is advanced to, in seconds.
+	 * @param tick The tick of that time.
+	 */
+	void fire(double time, std::uint64_t tick);
+
+	/** @brief Holds the time of a tick, in seconds. */
+	double m_tickTime;
+
+	/** @brief Holds the time of the clock, in seconds. */
+	double m_time;
+
+	/** @brief Holds the current tick, every tick before it fired. */
+	std::uint64_t m_tick;
+
+	/** @brief Holds the first timer of every slot, of every level, or none. */
+	std::uint32_t m_slots[levelCount * slotCount];
+
+	/** @brief Holds the timers, pending and free. */
+	std::vector<Timer> m_timers;
+
+	/** @brief Holds the first free timer on the pool, or none. */
+	std::uint32_t m_freeTimer;
+
+	/** @brief Holds the number of pending timers. */
+	std::size_t m_pendingCount;
+
+	/** @brief Holds the number of the next timer scheduled. */
+	std::uint64_t m_nextSequence;
+
+	/** @brief Holds the identifiers of the timers being fired, taken from their slot. */
+	std::vector<TimerId> m_firing;
+
+	/** @brief Holds the statistics. */
+	Stats m_stats;
+};
@@ -0,0 +1,97 @@
+/*****************************************************************
+ * \file	TripleBuffer.hpp
+ * \brief	Header is for template class TripleBuffer (header only)
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+/**
+ * @brief TripleBuffer template class hands the latest value from one producer thread to one consumer thread,
+ * without locks and without either thread ever waiting for the other: the producer writes a buffer of its own,
+ * the consumer reads a buffer of its own, and the third buffer is swapped atomically between them.
+ * Values published faster than they are consumed are skipped, only the latest is read.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+	/**
+	 * @brief Default constructor.
+	 */
+	TripleBuffer() :
+		m_middle(1),
+		m_write(0),
+		m_read(2)
+	{
+	}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	/**
+	 * @brief Method which gives access to the buffer to be written, by the producer thread only.
+	 * Its content is a value published two times ago, or older, so it is to be fully rewritten.
+	 * @return The buffer to be written.
+	 */
+	T& getWriteBuffer()
+	{
+		return m_buffers[m_write];
+	}
+
+	/**
+	 * @brief Method which publishes the written buffer, by the producer thread only.
+	 */
+	void publish()
+	{
+		unsigned previous = m_middle.exchange(m_write | FreshFlag, std::memory_order_acq_rel);
+		m_write = previous & IndexMask;
+	}
+
+	/**
+	 * @brief Method which acquires the latest published buffer, if there is a new one, by the consumer thread only.
+	 * @return The value of true if a new buffer was acquired.
+	 */
+	bool acquire()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & FreshFlag) == 0) {
+			return false;
+		}
+		unsigned previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+		m_read = previous & IndexMask;
+		return true;
+	}
+
+	/**
+	 * @brief Method which gives access to the last acquired buffer, by the consumer thread only.
+	 * It stays valid, and unchanged, until the next acquire().
+	 * @return The buffer to be read.
+	 */
+	const T& getReadBuffer() const
+	{
+		return m_buffers[m_read];
+	}
+
+private:
+	/** @brief Holds the mask of the buffer index, within \pm_middle. */
+	static const unsigned IndexMask = 3;
+
+	/** @brief Holds the flag, within \pm_middle, set when the middle buffer hasn't been acquired yet. */
+	static const unsigned FreshFlag = 4;
+
+	/** @brief Holds the three buffers. */
+	T m_buffers[3];
+
+	/** @brief Holds the index of the buffer in between the threads, and its fresh flag. */
+	std::atomic<unsigned> m_middle;
+
+	/** @brief Holds the index of the buffer owned by the producer thread. */
+	unsigned m_write;
+
+	/** @brief Holds the index of the buffer owned by the consumer thread. */
+	unsigned m_read;
+};
@@ -8,22 +8,27 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace sf {
-	class RenderWindow;
+	class RenderTarget;
+	class Texture;
 }
 
 /**
  * @brief WindowInterface class is an interface to enable objects to be rendered
  * to be drawn to a specific window, the idea is that the window can call objects with this interface
  * to render them when they're supposed to be rendered.
+ * Objects mark themselves dirty whenever what they draw changes, so that a window caching their render
+ * only redraws it when needed.
  */
 class WindowInterface
 {
 public:
 	/**
-	 * @brief Default constructor.
+	 * @brief Constructor, the object starts dirty.
 	 */
-	WindowInterface() = default;
+	WindowInterface();
 
 	/**
 	 * @brief Default destructor.
@@ -31,9 +36,46 @@ public:
 	~WindowInterface() = default;
 
 	/**
-	 * @brief Method which draws a shape to a specific window.
-	 * @param window The window object reference.
+	 * @brief Method which draws a shape to a specific render target.
+	 * @param target The render target, a window or an offscreen texture.
+	 */
+	virtual void drawTo(sf::RenderTarget* target) = 0;
+
+	/**
+	 * @brief Method which gets the number of draw passes of the object, each one draw call with one texture,
+	 * so that a render queue can group the passes of the objects of a layer by texture. A pass may only cover
+	 * what the previous passes of the same object do, the passes of the other objects of its layer being drawn in between.
+	 * @return The number of passes, 1 by default.
+	 */
+	virtual std::size_t getDrawPassCount() const;
+
+	/**
+	 * @brief Method which gets the texture a draw pass uses.
+	 * @param pass The draw pass.
+	 * @return The texture, nullptr if none (or unknown, by default).
+	 */
+	virtual const sf::Texture* getDrawPassTexture(std::size_t pass) const;
+
+	/**
+	 * @brief Method which draws a draw pass of the object to a specific render target.
+	 * @param target The render target, a window or an offscreen texture.
+	 * @param pass The draw pass, the whole object by default.
+	 */
+	virtual void drawPassTo(sf::RenderTarget* target, std::size_t pass);
+
+	/**
+	 * @brief Method which checks if what the object draws changed since the last check, and clears the flag.
+	 * @return The value of true if it changed.
+	 */
+	bool takeDirty();
+
+protected:
+	/**
+	 * @brief Method which marks that what the object draws changed.
 	 */
-	virtual void drawTo(sf::RenderWindow* window) = 0;
+	void markDirty();
 
+private:
+	/** @brief Holds the flag value, true if what the object draws changed since the last check. */
+	bool m_dirty;
 };
\ No newline at end of file
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <SFML/System/Vector2.hpp>
@@ -16,6 +18,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include "RenderQueue.hpp"
+
 class WindowInterface;
 class ButtonInterface;
 
@@ -24,6 +28,10 @@ class ButtonInterface;
  * can be added to each window objects. Some of the main functionalities of this class are:
  * holding the renference to objects that can be rendered, rendering these objects on calling drawChildren()
  * render them by layer order to pass OpenGL Z-Buffer Test.
+ * The bottom layers, whose children rarely change (background, frames, labels), can be cached:
+ * they are composited once into an offscreen texture, redrawn only when one of their children is dirty,
+ * and each frame costs a single opaque quad, instead of overdrawing the whole window with each of them.
+ * The children are drawn through a render queue, sorted by texture within each layer.
  */
 class WindowModel : public sf::RenderWindow
 {
@@ -60,10 +68,11 @@ public:
 	void onResize() override;
 
 	/**
-	 * @brief Method which adds a child shape to be rendered on window.
+	 * @brief Method which adds a child shape to be rendered on window, after the children already added.
 	 * @param child The child shape of WindowInterface type.
+	 * @param layer The render layer of the child, the top one by default.
 	 */
-	void addChild(boost::shared_ptr<WindowInterface> child);
+	void addChild(boost::shared_ptr<WindowInterface> child, Layer layer = l5);
 
 	/**
 	 * @brief Method which adds a child button to be rendered on window.
@@ -73,16 +82,64 @@ public:
 
 	/**
 	 * @brief Method which draws the children shapes of type WindowInterface.
+	 * The cached layers are drawn first, as one quad, redrawn beforehand if one of their children is dirty.
 	 */
 	void drawChildren();
 
+	/**
+	 * @brief Method which sets if the bottom layers are cached. The cached layers must be opaque as a whole,
+	 * the quad replaces what is under it.
+	 * @param enable The enable flag.
+	 * @param lastLayer The top cached layer, every layer below it is cached too.
+	 * @return The value of true if the layers are cached, false if disabled, or if the offscreen texture can't be created.
+	 */
+	bool enableLayerCache(bool enable, Layer lastLayer = l2);
+
+	/**
+	 * @brief Method which forces the cached layers to be redrawn on the next frame, for changes the children can't mark.
+	 */
+	void invalidateLayerCache();
+
+	/**
+	 * @brief Method which gets the number of times the cached layers were redrawn.
+	 * @return The number of redraws.
+	 */
+	std::size_t getLayerCacheRedrawCount() const;
+
+	/**
+	 * @brief Method which gets the render queue of the children, and its draw and bind counts.
+	 * @return The render queue.
+	 */
+	const RenderQueue& getRenderQueue() const;
+
 private:
 	/** @brief Holds the original window size from when WindowModel was created. */
 	const sf::Vector2u m_originalSize;
 
-	/** @brief Holds the vector of WindowInterface references (not the owner). */
-	std::vector<boost::shared_ptr<WindowInterface>> m_children;
+	/** @brief Holds the vector of WindowInterface references (not the owner), with their render layer. */
+	std::vector<std::pair<boost::shared_ptr<WindowInterface>, Layer>> m_children;
+
+	/** @brief Holds the draws of the children, sorted by layer and texture. */
+	RenderQueue m_renderQueue;
 
 	/** @brief Holds the vector of ButtonInterface references (not the owner). */
 	std::vector<boost::shared_ptr<ButtonInterface>> m_buttons;
+
+	/** @brief Holds the flag value, true if the bottom layers are cached. */
+	bool m_layerCacheEnabled;
+
+	/** @brief Holds the top cached layer. */
+	Layer m_lastCachedLayer;
+
+	/** @brief Holds the flag value, true if the cached layers are to be redrawn whatever their children. */
+	bool m_layerCacheInvalid;
+
+	/** @brief Holds the number of times the cached layers were redrawn. */
+	std::size_t m_layerCacheRedraws;
+
+	/** @brief Holds the offscreen texture the cached layers are composited into, created on first use. */
+	boost::shared_ptr<sf::RenderTexture> m_layerCache;
+
+	/** @brief Holds the quad which draws the cached layers to the window. */
+	sf::Sprite m_layerCacheSprite;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@
 ******************************************************************/
 
 #include "BoxShape.hpp"
+#include "ResourceManager.hpp"
 #include <boost/shared_ptr.hpp>
 
 BoxShape::BoxShape(const sf::Vector2f& pos,
@@ -33,17 +34,13 @@ BoxShape::BoxShape(const sf::Vector2f& pos,
 
 void BoxShape::setTexture(const std::string& path, TextureMask mask, bool activate)
 {
-	//allocate
-	p_textureMap[mask] = boost::shared_ptr<sf::Texture>(new sf::Texture);
+	//shared, decoded only once
+	p_textureMap[mask] = ResourceManager::getTexture(path);
 	p_currentMask = mask;
-	if (p_textureMap[mask]->loadFromFile(path)) {
+	markDirty();
 
-		if (activate) {
-			enableTexture(activate);
-		}
-	}
-	else {
-		throw("CAN'T LOAD TEXTURE: " + path);
+	if (activate) {
+		enableTexture(activate);
 	}
 }
 
@@ -51,6 +48,7 @@ void BoxShape::swapTexture(TextureMask mask) {
 	if (p_textureMap.count(mask) != 0 && p_currentMask != mask) {
 		p_currentMask = mask;
 		enableTexture(p_textureActive);
+		markDirty();
 	}
 }
 
@@ -66,27 +64,36 @@ void BoxShape::enableTexture(bool enable) {
 			//TODO: set new methods for setTextureRect() interface
 		}
 		p_textureActive = enable;
+		markDirty();
 	}
 }
 
 void BoxShape::resetPositon(const sf::Vector2f& pos)
 {
 	p_rectangleShape.setPosition(pos);
+	markDirty();
 }
 
-void BoxShape::drawTo(sf::RenderWindow* window)
+void BoxShape::drawTo(sf::RenderTarget* target)
 {
-	if (window != nullptr) {
-		window->draw(p_rectangleShape);
+	if (target != nullptr) {
+		target->draw(p_rectangleShape);
 	}
 }
 
+const sf::Texture* BoxShape::getDrawPassTexture(std::size_t /*pass*/) const
+{
+	return p_rectangleShape.getTexture();
+}
+
 void BoxShape::rotate(float degrees) {
 
 	p_rectangleShape.setRotation(degrees);
+	markDirty();
 }
 
 void BoxShape::scale(const sf::Vector2f& scale) {
 
 	p_rectangleShape.setScale(scale);
+	markDirty();
 }
\ No newline at end of file
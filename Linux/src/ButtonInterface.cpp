@@ -8,13 +8,10 @@
 
 #include "ButtonInterface.hpp"
 
-ButtonInterface::ButtonInterface() : p_clickCallback(nullptr) {};
+ButtonInterface::ButtonInterface() {};
 
-void ButtonInterface::setClickCallback(
-	void (*callback)(std::map<std::string, void*>),
-	const std::map<std::string, void*>& argsMap)
+void ButtonInterface::setClickCallback(const Delegate<void()>& callback)
 {
 	p_clickCallback = callback;
-	p_clickCallbackArgsMap = argsMap;
 }
 
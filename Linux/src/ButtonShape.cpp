@@ -7,7 +7,7 @@
 ******************************************************************/
 
 #include "ButtonShape.hpp"
-#include "CustomSound.hpp"
+#include "SoundEffect.hpp"
 
 ButtonShape::ButtonShape(const std::string& text, const sf::Vector2f& pos,
 	const sf::Vector2f& size, const sf::Color& backgroundColor, const sf::Color& textColor, int textSize) :
@@ -23,8 +23,11 @@ ButtonShape::ButtonShape(const std::string& text, const sf::Vector2f& pos,
 
 bool ButtonShape::isMouseOver(sf::RenderWindow* window)
 {
-	sf::Vector2i mousePos = sf::Mouse::getPosition(*window);
+	return isMouseOver(sf::Mouse::getPosition(*window));
+}
 
+bool ButtonShape::isMouseOver(const sf::Vector2i& mousePos)
+{
 	sf::Vector2f rectPos = p_rectangleShape.getPosition();
 
 	float rectMarginX = p_rectangleShape.getLocalBounds().width / 2;
@@ -42,6 +45,7 @@ bool ButtonShape::isMouseOver(sf::RenderWindow* window)
 		if (m_state != Inside) {
 			m_state = Inside;
 			m_toggled = true;
+			markDirty();//highlighted
 		}
 		else {
 			m_toggled = false;
@@ -53,6 +57,7 @@ bool ButtonShape::isMouseOver(sf::RenderWindow* window)
 		if (m_state != Outside) {
 			m_state = Outside;
 			m_toggled = true;
+			markDirty();//back to its color
 		}
 		else {
 			m_toggled = false;
@@ -61,11 +66,11 @@ bool ButtonShape::isMouseOver(sf::RenderWindow* window)
 	}
 }
 
-void ButtonShape::drawTo(sf::RenderWindow* window)
+void ButtonShape::drawTo(sf::RenderTarget* target)
 {
-	if (window != nullptr) {
-		window->draw(p_rectangleShape);
-		window->draw(p_text);
+	if (target != nullptr) {
+		target->draw(p_rectangleShape);
+		target->draw(p_text);
 	}
 }
 
@@ -79,11 +84,12 @@ bool ButtonShape::toggled()
 	return m_toggled;
 }
 
-void ButtonShape::onWindowEvent(sf::RenderWindow* window, const sf::Event& evnt)
+void ButtonShape::onWindowEvent(sf::RenderWindow* /*window*/, const sf::Event& evnt)
 {
 	switch (evnt.type) {
+	//hit tested where the event happened, not where the mouse is now (so replayed events hit the same buttons):
 	case sf::Event::MouseMoved:
-		if (isMouseOver(window)) {
+		if (isMouseOver(sf::Vector2i(evnt.mouseMove.x, evnt.mouseMove.y))) {
 			//hover sound:
 			if (getState() == ButtonShape::Inside && toggled() &&
 				m_hoverSound != nullptr && m_hoverSoundActive) {
@@ -92,24 +98,33 @@ void ButtonShape::onWindowEvent(sf::RenderWindow* window, const sf::Event& evnt)
 		}
 		break;
 	case sf::Event::MouseButtonPressed:
-		if (isMouseOver(window)) {
+		if (isMouseOver(sf::Vector2i(evnt.mouseButton.x, evnt.mouseButton.y))) {
 			//click sound:
 			if (m_clickSound != nullptr && m_clickSoundActive) {
 				m_clickSound->play();
 			}
 
 			//callback:
-			if (p_clickCallback != nullptr) {
-				p_clickCallback(p_clickCallbackArgsMap);
+			if (p_clickCallback) {
+				p_clickCallback();
 			}
 		}
 		break;
 	}
 }
 
+sf::FloatRect ButtonShape::getHitBounds() const
+{
+	//the same area as isMouseOver():
+	const sf::Vector2f rectPos = p_rectangleShape.getPosition();
+	const float width = p_rectangleShape.getLocalBounds().width;
+	const float height = p_rectangleShape.getLocalBounds().height;
+	return sf::FloatRect(rectPos.x - width / 2, rectPos.y - height / 2, width, height);
+}
+
 void ButtonShape::setHoverSound(const std::string& path, bool activate)
 {
-	m_hoverSound.reset(new CustomSound(path));
+	m_hoverSound.reset(new SoundEffect(path, SoundPool::High));
 	if (activate) {
 		enableHoverSound(activate);
 	}
@@ -121,7 +136,7 @@ void ButtonShape::enableHoverSound(bool enable) {
 
 void ButtonShape::setClickSound(const std::string& path, bool activate)
 {
-	m_clickSound.reset(new CustomSound(path));
+	m_clickSound.reset(new SoundEffect(path, SoundPool::High));
 	if (activate) {
 		enableClickSound(activate);
 	}
@@ -12,36 +12,127 @@
 #include "ButtonShape.hpp"
 #include "CustomSound.hpp"
 #include "PolyParticleShape.hpp"
+#include "ParticleSystem.hpp"
+#include "ParticleBatch.hpp"
+#include "GameLoop.hpp"
+#include "CreditJournal.hpp"
+#include "SnapshotFile.hpp"
+#include "HitTestGrid.hpp"
+#include "RandomEngine.hpp"
+#include "MathModule.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 CasinoGame::CasinoGame(boost::shared_ptr<WindowModel> windowModel) :
 	m_currentWindow(windowModel),
 	m_winSize({ float(windowModel->getSize().x),float(windowModel->getSize().y) }),
+	m_particleSystem(new ParticleSystem),
+	m_randomStatePending(false),
+	m_playSaved(false),
+	m_interpolationAlpha(1),
+	m_simulationRunning(false),
+	m_playCountText(nullptr),
+	m_creditsInsertedText(nullptr),
+	m_creditsRemovedText(nullptr),
+	m_startButton(nullptr),
+	m_particleBatch(nullptr),
 	m_numberOfParticleToGenerate(50)
 {
 }
 
+CasinoGame::CasinoGame(const sf::Vector2u& areaSize) :
+	m_currentWindow(nullptr),
+	m_winSize({ float(areaSize.x),float(areaSize.y) }),
+	m_particleSystem(new ParticleSystem),
+	m_randomStatePending(false),
+	m_playSaved(false),
+	m_interpolationAlpha(1),
+	m_simulationRunning(false),
+	m_playCountText(nullptr),
+	m_creditsInsertedText(nullptr),
+	m_creditsRemovedText(nullptr),
+	m_startButton(nullptr),
+	m_particleBatch(nullptr),
+	m_numberOfParticleToGenerate(50)
+{
+}
+
+CasinoGame::~CasinoGame()
+{
+	stopSimulationThread();
+}
+
+const CasinoGame::State& CasinoGame::getState() const {
+	return m_currentState;
+}
+
+std::uint32_t CasinoGame::getSimulationChecksum() const {
+	std::vector<unsigned char> data(4 * sizeof(std::uint32_t) + m_particleSystem->getSnapshotSize());
+	const std::uint32_t counters[4] = {
+		m_currentState.playCount,
+		m_currentState.insertCount,
+		m_currentState.removeCount,
+		std::uint32_t(m_currentState.physicsPaused ? 1 : 0) | std::uint32_t(m_currentState.playOngoing ? 2 : 0)
+	};
+	std::memcpy(data.data(), counters, sizeof(counters));
+	m_particleSystem->writeSnapshot(data.data() + sizeof(counters));
+	return MathModule::getChecksum(data.data(), data.size());
+}
+
+boost::shared_ptr<CreditJournal> CasinoGame::getCreditJournal() const {
+	return m_creditJournal;
+}
+
+boost::shared_ptr<SnapshotFile> CasinoGame::getPlaySnapshots() const {
+	return m_playSnapshots;
+}
+
+boost::shared_ptr<HitTestGrid> CasinoGame::getHitTestGrid() const {
+	return m_hitTestGrid;
+}
+
+bool CasinoGame::isHeadless() const {
+	return m_currentWindow == nullptr;
+}
+
 WindowModel* CasinoGame::getCurrentWindow() {
 	return m_currentWindow.get();
 }
 
 void CasinoGame::init() {
+	Profiler::Zone zone("CasinoGame::init");
 	loadState();
 
+	if (isHeadless()) {
+		//simulation only:
+		initParticleObjects();
+		connectParticleObjects();
+		restorePlay();
+		return;
+	}
+
 	initMusic();
-	
+
+	//particles first, the play they may resume sets the state the texts show:
+	initParticleObjects();
+	connectParticleObjects();
+	restorePlay();
+
 	initBackground();
 	initStaticTexts();
 	initDynamicTexts();
-	initParticleObjects();
 	initButtons();
 
-	connectParticleObjects();
 	connectButtons();
+	connectViews();
 
 	addShapesToWindow();
 }
 
 void CasinoGame::initMusic() {
+	Profiler::Zone zone("CasinoGame::initMusic");
 	boost::shared_ptr<CustomSound> mainLoopSound =
 		boost::shared_ptr<CustomSound>(new CustomSound("MyResources/Sounds/mainLoop.ogg"));
 	mainLoopSound->setLoop(true);
@@ -52,26 +143,145 @@ void CasinoGame::initMusic() {
 
 void CasinoGame::switchToWindow(boost::shared_ptr<WindowModel> windowModel)
 {
-	m_currentWindow->removeButtons({ m_buttonMap["StartButton"] ,m_buttonMap["CreditsInButton"] ,m_buttonMap["CreditsOutButton"] });
+	if (m_currentWindow != nullptr) {
+		m_currentWindow->removeButtons({ m_buttonMap["StartButton"] ,m_buttonMap["CreditsInButton"] ,m_buttonMap["CreditsOutButton"] });
+	}
 	m_currentWindow = windowModel;
 	m_winSize = { float(windowModel->getSize().x),float(windowModel->getSize().y) };
 
 	init();
 }
 
+void CasinoGame::openCreditJournal(const std::string& path)
+{
+	m_creditJournal = boost::shared_ptr<CreditJournal>(new CreditJournal(path));
+}
+
 void CasinoGame::loadState()
 {
-	if (false) {
-		//TODO: load from binary file the current State
+	if (m_creditJournal != nullptr) {
+		//counters recovered from the journal, a play interrupted by a restart is resumed later, by restorePlay():
+		CreditJournal::Counters counters = m_creditJournal->getCounters();
+		m_currentState = State(counters.playCount, counters.insertCount, counters.removeCount, false, false);
 	}
 	else
 	{
-		m_currentState = State();
+		m_currentState = State(m_initialState.playCount, m_initialState.insertCount, m_initialState.removeCount, false, false);
+	}
+}
+
+void CasinoGame::openPlaySnapshots(const std::string& path)
+{
+	m_playSnapshotPath = path;
+}
+
+void CasinoGame::setKinematics(ParticleSystem::Kinematics kinematics)
+{
+	m_particleSystem->setKinematics(kinematics);
+}
+
+void CasinoGame::setInitialState(const State& state)
+{
+	m_initialState = state;
+}
+
+std::size_t CasinoGame::getPlaySnapshotSize() const
+{
+	//state, seed and random engine, then the particles:
+	return 4 * sizeof(std::uint32_t) + 5 * sizeof(std::uint64_t) + m_particleSystem->getSnapshotSize();
+}
+
+void CasinoGame::restorePlay()
+{
+	if (m_playSnapshotPath.empty()) {
+		return;
+	}
+	Profiler::Zone zone("CasinoGame::restorePlay");
+	m_playSnapshots = boost::shared_ptr<SnapshotFile>(new SnapshotFile(m_playSnapshotPath, getPlaySnapshotSize()));
+
+	std::vector<unsigned char> data;
+	if (!m_playSnapshots->getRecoveredSnapshot(data) || data.size() != getPlaySnapshotSize()) {
+		return;
+	}
+
+	std::uint32_t counters[4];
+	std::uint64_t seed;
+	std::uint64_t randomState[4];
+	std::memcpy(counters, data.data(), sizeof(counters));
+	std::memcpy(&seed, data.data() + sizeof(counters), sizeof(seed));
+	std::memcpy(randomState, data.data() + sizeof(counters) + sizeof(seed), sizeof(randomState));
+	const unsigned char* particles = data.data() + sizeof(counters) + sizeof(seed) + sizeof(randomState);
+	const bool physicsPaused = (counters[3] & 1) != 0;
+	const bool playOngoing = (counters[3] & 2) != 0;
+
+	if (m_creditJournal == nullptr) {
+		m_currentState.playCount = counters[0];
+		m_currentState.insertCount = counters[1];
+		m_currentState.removeCount = counters[2];
+	}
+	else if (counters[0] != m_currentState.playCount || counters[1] != m_currentState.insertCount ||
+		counters[2] != m_currentState.removeCount) {
+		//the snapshot doesn't match the durable credits: the journal holds a later event (a stale snapshot), or lost one
+		//(a play whose credit was never durably spent), either way the play isn't resumed:
+		return;
+	}
+
+	//resume the play in flight, its credit was already consumed:
+	if (playOngoing && m_particleSystem->readSnapshot(particles, data.size() - (particles - data.data()))) {
+		m_currentState.playOngoing = m_particleSystem->getAliveCount() > 0;
+		m_currentState.physicsPaused = physicsPaused;
+
+		//the engine is the one of the thread running the physics, the simulation thread under --threaded, not this one:
+		MathModule::setRandomSeed(seed);
+		std::memcpy(m_restoredRandomState, randomState, sizeof(randomState));
+		m_randomStatePending = true;
+	}
+}
+
+void CasinoGame::savePlay()
+{
+	if (m_playSnapshots == nullptr) {
+		return;
+	}
+	Profiler::Zone zone("CasinoGame::savePlay");
+
+	std::uint32_t counters[4] = {
+		m_currentState.playCount,
+		m_currentState.insertCount,
+		m_currentState.removeCount,
+		std::uint32_t(m_currentState.physicsPaused ? 1 : 0) | std::uint32_t(m_currentState.playOngoing ? 2 : 0)
+	};
+
+	//between plays only the counters matter, written once when they change:
+	if (!m_currentState.playOngoing && m_playSaved && std::memcmp(counters, m_savedPlayCounters, sizeof(counters)) == 0) {
+		return;
+	}
+	std::memcpy(m_savedPlayCounters, counters, sizeof(counters));
+	m_playSaved = true;
+
+	unsigned char* data = m_playSnapshots->beginWrite();
+	std::uint64_t seed = MathModule::getRandomSeed();
+	std::uint64_t randomState[4];
+	RandomEngine::getThreadEngine().getState(randomState);
+
+	std::memcpy(data, counters, sizeof(counters));
+	std::memcpy(data + sizeof(counters), &seed, sizeof(seed));
+	std::memcpy(data + sizeof(counters) + sizeof(seed), randomState, sizeof(randomState));
+	m_particleSystem->writeSnapshot(data + sizeof(counters) + sizeof(seed) + sizeof(randomState));
+
+	m_playSnapshots->endWrite(getPlaySnapshotSize());
+}
+
+void CasinoGame::journalEvent(unsigned int event)
+{
+	if (m_creditJournal != nullptr) {
+		m_creditJournal->append(CreditJournal::Event(event));
 	}
 }
 
 void CasinoGame::initBackground()
 {
+	Profiler::Zone zone("CasinoGame::initBackground");
 	//setup background:
 	boost::shared_ptr<BoxShape> skyShape =
 		boost::shared_ptr<BoxShape>(new BoxShape({ m_winSize.x / 2.0f, m_winSize.y / 2.0f }, m_winSize, "MyResources/Textures/background.jpg"));
@@ -92,6 +302,7 @@ void CasinoGame::initBackground()
 
 void CasinoGame::initStaticTexts()
 {
+	Profiler::Zone zone("CasinoGame::initStaticTexts");
 	//Static Texts:
 	sf::Vector2f shapeSize({ 150,50 });
 	float shapeHeight = 37;
@@ -117,6 +328,7 @@ void CasinoGame::initStaticTexts()
 
 void CasinoGame::initDynamicTexts()
 {
+	Profiler::Zone zone("CasinoGame::initDynamicTexts");
 	//Dynamic Texts:
 	sf::Vector2f shapeSize = { 100,40 };
 	float shapeHeight = 35 + 50;
@@ -144,42 +356,61 @@ void CasinoGame::initDynamicTexts()
 }
 
 void CasinoGame::initParticleObjects() {
-	std::string nameID;
+	Profiler::Zone zone("CasinoGame::initParticleObjects");
 	boost::shared_ptr<PolyParticleShape> particleObject;
+	std::vector<boost::shared_ptr<PolyParticleShape>> particleObjects;
+	m_particleSystem->reserve(m_numberOfParticleToGenerate);
+	m_particles.reserve(m_numberOfParticleToGenerate);
+
+	//all particles share the same texture, and are rendered in one draw call:
+	boost::shared_ptr<ParticleBatch> particleBatch;
+	if (!isHeadless()) {
+		particleBatch = boost::shared_ptr<ParticleBatch>(new ParticleBatch());
+	}
+
 	for (int i = 0; i < m_numberOfParticleToGenerate; i++) {
 		particleObject =
-			boost::shared_ptr<PolyParticleShape>(new PolyParticleShape({ (m_winSize.x / 2.0f),(m_winSize.y / 2.0f) }, 10, 20, sf::Color::White));
-		particleObject->setTexture("MyResources/Textures/gold.jpg");
-		particleObject->setBirthSound("MyResources/Sounds/jumpIn.ogg");
-		particleObject->setDeathSound("MyResources/Sounds/jumpOut.ogg");
+			boost::shared_ptr<PolyParticleShape>(new PolyParticleShape(m_particleSystem, { (m_winSize.x / 2.0f),(m_winSize.y / 2.0f) }, 10, 20, sf::Color::White));
+		if (!isHeadless()) {
+			particleObject->setTexture("MyResources/Textures/gold.jpg");
+			particleObject->setBirthSound("MyResources/Sounds/jumpIn.ogg");
+			particleObject->setDeathSound("MyResources/Sounds/jumpOut.ogg");
+		}
 
 		particleObject->randomizeColor();
-		particleObject->setRandomBirthStateParams(m_winSize);
-		particleObject->setupRandomBirthState();
 
-		nameID = "JumpObject" + std::to_string(i);
-		m_shapeMap[nameID] = { boost::dynamic_pointer_cast<WindowInterface>(particleObject) ,int(WindowModel::l3) };
-		m_particleMap[nameID] = boost::dynamic_pointer_cast<ParticleInterface>(particleObject);
+		if (particleBatch != nullptr) {
+			particleBatch->addParticle(*particleObject);
+		}
+		particleObjects.push_back(particleObject);
+		m_particles.push_back(boost::dynamic_pointer_cast<ParticleInterface>(particleObject));
+	}
+
+	//random birth states, drawn in bulk:
+	PolyParticleShape::setupRandomBirthStates(particleObjects, m_winSize);
+
+	//add to map, in order to be rendered:
+	if (particleBatch != nullptr) {
+		m_shapeMap["ParticleBatch"] = { boost::dynamic_pointer_cast<WindowInterface>(particleBatch) ,int(WindowModel::l3) };
 	}
 }
 
 void CasinoGame::connectParticleObjects() {
 	//connect particles to other elements of the game
+	m_particleSystem->setDeathCondition(ParticleSystem::DeathCondition::fromFunction<&CasinoGame::particleDeathCondition>());
+	m_particleSystem->setDeathBoundary({ 1, 0 }, 0);//the same left side, for Analytic kinematics
 
-	for (std::pair<std::string, boost::shared_ptr<ParticleInterface> > particlePair : m_particleMap) {
-		std::map<std::string, void*> argsMap;
-		argsMap["textObject"] = (void*)(m_shapeMap["PlayCountValueText"].first.get());
-		argsMap["particleMap"] = &m_particleMap;
-		argsMap["trackValues"] = &m_currentState;
-		argsMap["currentParticle"] = (void*)(m_particleMap[particlePair.first].get());
-		argsMap["startButton"] = (void*)(m_shapeMap["StartButton"].first.get());
-		particlePair.second->setDeathCondition(&CasinoGame::particleDeathCondition, argsMap);
-	}
+	//end of play, raised once by the particle system:
+	m_particleSystem->setAllDeadCallback(Delegate<void()>::fromMethod<CasinoGame, &CasinoGame::onAllParticlesDead>(this));
+
+	m_birthEvents.assign(m_particles.size(), 0);
+	m_deathEvents.assign(m_particles.size(), 0);
 }
 
 
 void CasinoGame::initButtons()
 {
+	Profiler::Zone zone("CasinoGame::initButtons");
 	//buttons:
 	sf::Vector2f shapeSize = { 150,50 };
 	float shapeHeight = m_winSize.y - 37;
@@ -213,68 +444,231 @@ void CasinoGame::initButtons()
 	m_buttonMap["StartButton"] = boost::dynamic_pointer_cast<ButtonInterface>(startButton);
 	m_buttonMap["CreditsInButton"] = boost::dynamic_pointer_cast<ButtonInterface>(creditsInButton);
 	m_buttonMap["CreditsOutButton"] = boost::dynamic_pointer_cast<ButtonInterface>(creditsOutButton);
+
+	//and to the hit test grid, which sends them the events (their bounds are fixed from now on, the buttons never move):
+	m_hitTestGrid = boost::shared_ptr<HitTestGrid>(new HitTestGrid(m_winSize));
+	for (const std::pair<const std::string, boost::shared_ptr<ButtonInterface>>& button : m_buttonMap) {
+		m_hitTestGrid->add(button.second);
+	}
 }
 
 void CasinoGame::connectButtons()
 {
-	//connect buttons to mouse and window
-	if (m_shapeMap.count("StartButton") != 0) {
-		std::map<std::string, void*> argsMap;
-		argsMap["textObject"] = (void*)(m_shapeMap["CreditsInsertedValueText"].first.get());
-		argsMap["currentButton"] = (void*)(m_shapeMap["StartButton"].first.get());
-		argsMap["particleMap"] = &m_particleMap;
-		argsMap["trackValues"] = &m_currentState;
-		m_buttonMap["StartButton"]->setClickCallback(&CasinoGame::onStartButton, argsMap);
+	//connect buttons to mouse and window, they only issue commands to the simulation:
+	if (m_buttonMap.count("StartButton") != 0) {
+		m_buttonMap["StartButton"]->setClickCallback(Delegate<void()>::fromFunctor([this]() {
+			issueCommand(Start);
+		}));
 	}
 
-	if (m_shapeMap.count("CreditsInButton") != 0) {
-		std::map<std::string, void*> argsMap;
-		argsMap["textObject"] = (void*)(m_shapeMap["CreditsInsertedValueText"].first.get());
-		argsMap["trackValues"] = &m_currentState;
-		m_buttonMap["CreditsInButton"]->setClickCallback(&CasinoGame::onCreditsInButton, argsMap);
+	if (m_buttonMap.count("CreditsInButton") != 0) {
+		m_buttonMap["CreditsInButton"]->setClickCallback(Delegate<void()>::fromFunctor([this]() {
+			issueCommand(CreditsIn);
+		}));
 	}
 
-	if (m_shapeMap.count("CreditsOutButton") != 0) {
-		std::map<std::string, void*> argsMap;
-		argsMap["incrementObject"] = (void*)(m_shapeMap["CreditsRemovedValueText"].first.get());
-		argsMap["decrementObject"] = (void*)(m_shapeMap["CreditsInsertedValueText"].first.get());
-		argsMap["trackValues"] = &m_currentState;
-		m_buttonMap["CreditsOutButton"]->setClickCallback(&CasinoGame::onCreditsOutButton, argsMap);
+	if (m_buttonMap.count("CreditsOutButton") != 0) {
+		m_buttonMap["CreditsOutButton"]->setClickCallback(Delegate<void()>::fromFunctor([this]() {
+			issueCommand(CreditsOut);
+		}));
 	}
 }
 
+void CasinoGame::connectViews()
+{
+	//resolve the views synchronized with the snapshots once:
+	m_playCountText = dynamic_cast<TextShape*>(m_shapeMap["PlayCountValueText"].first.get());
+	m_creditsInsertedText = dynamic_cast<TextShape*>(m_shapeMap["CreditsInsertedValueText"].first.get());
+	m_creditsRemovedText = dynamic_cast<TextShape*>(m_shapeMap["CreditsRemovedValueText"].first.get());
+	m_startButton = dynamic_cast<ButtonShape*>(m_shapeMap["StartButton"].first.get());
+	m_particleBatch = dynamic_cast<ParticleBatch*>(m_shapeMap["ParticleBatch"].first.get());
+
+	//the views were initialized with the current counters, and the start button for no play ongoing:
+	m_viewState = m_currentState;
+	m_viewState.playOngoing = false;
+	m_viewState.physicsPaused = false;
+	m_seenBirthEvents = m_birthEvents;
+	m_seenDeathEvents = m_deathEvents;
+
+	publishSnapshot(0);
+}
+
 void CasinoGame::updateButtonsOnWindowEvent(const sf::Event& evnt)
 {
-	for (std::pair<std::string, boost::shared_ptr<ButtonInterface>> button : m_buttonMap) {
-		if (button.second != nullptr) {
-			button.second->onWindowEvent(m_currentWindow.get(), evnt);
-		}
+	Profiler::Zone zone("CasinoGame::updateButtonsOnWindowEvent");
+	if (m_hitTestGrid != nullptr) {
+		m_hitTestGrid->dispatch(m_currentWindow.get(), evnt);
 	}
 }
 
+void CasinoGame::issueCommand(Command command)
+{
+	std::lock_guard<std::mutex> lock(m_commandMutex);
+	m_issuedCommands.push_back(command);
+}
+
 void CasinoGame::updatePhysics(float deltaTime)
 {
+	Profiler::Zone zone("CasinoGame::updatePhysics");
+	m_simulationTimer.begin();
+
+	//continue the random sequence of a restored play, on this thread:
+	if (m_randomStatePending) {
+		RandomEngine::getThreadEngine().setState(m_restoredRandomState);
+		m_randomStatePending = false;
+	}
+
+	//apply the commands issued since the last step
+	{
+		std::lock_guard<std::mutex> lock(m_commandMutex);
+		m_appliedCommands.swap(m_issuedCommands);
+	}
+	for (Command command : m_appliedCommands) {
+		applyCommand(command);
+	}
+	m_appliedCommands.clear();
+
 	//update physics
-	m_currentState.playOngoing = false;//assume all particles are dead
+	if (!m_currentState.physicsPaused) {
+		//single pass over every particle state:
+		m_particleSystem->update(deltaTime);
+
+		for (ParticleSystem::Index index : m_particleSystem->getBornParticles()) {
+			m_birthEvents[index]++;
+		}
+
+		for (ParticleSystem::Index index : m_particleSystem->getDiedParticles()) {
+			m_deathEvents[index]++;
+		}
+	}
+
+	//check if play is still ongoing
+	m_currentState.playOngoing = m_particleSystem->getAliveCount() > 0;
+
+	publishSnapshot(deltaTime);
+	savePlay();
+
+	m_simulationTimer.end();
+}
+
+void CasinoGame::setInterpolationAlpha(float alpha)
+{
+	m_interpolationAlpha = alpha;
+}
 
-	for (std::pair<std::string, boost::shared_ptr<ParticleInterface>> particle : m_particleMap) {
-		if (particle.second != nullptr) {
+void CasinoGame::syncViews()
+{
+	Profiler::Zone zone("CasinoGame::syncViews");
+	if (m_snapshots.acquire()) {
+		const Snapshot& snapshot = m_snapshots.getReadBuffer();
+		const State& state = snapshot.state;
+
+		//texts, only when their value changed:
+		if (m_playCountText != nullptr && state.playCount != m_viewState.playCount) {
+			m_playCountText->resetContent(std::to_string(state.playCount));
+		}
+		if (m_creditsInsertedText != nullptr && state.insertCount != m_viewState.insertCount) {
+			m_creditsInsertedText->resetContent(std::to_string(state.insertCount));
+		}
+		if (m_creditsRemovedText != nullptr && state.removeCount != m_viewState.removeCount) {
+			m_creditsRemovedText->resetContent(std::to_string(state.removeCount));
+		}
 
-			//update physics
-			if (!m_currentState.physicsPaused) {
-				particle.second->updatePhysics(deltaTime);
+		//start button: pause while a play runs, start when paused, play once a play has ended
+		if (m_startButton != nullptr &&
+			(state.playOngoing != m_viewState.playOngoing || state.physicsPaused != m_viewState.physicsPaused)) {
+			if (state.playOngoing) {
+				m_startButton->resetContent(state.physicsPaused ? "START" : "PAUSE");
+				m_startButton->swapTexture(BoxShape::Mask1);
+			}
+			else {
+				m_startButton->resetContent(state.playCount > 0 ? "PLAY" : "START");
+				m_startButton->swapTexture(BoxShape::Mask0);
 			}
+		}
 
-			//check if play is still ongoing
-			if (!m_currentState.playOngoing && particle.second->isAlive()) {
-				m_currentState.playOngoing = true; //some particles are still alive
+		//particle sounds, once per particle even if snapshots were skipped:
+		for (std::size_t i = 0; i < m_particles.size() && i < snapshot.birthEvents.size(); i++) {
+			if (snapshot.birthEvents[i] != m_seenBirthEvents[i]) {
+				m_seenBirthEvents[i] = snapshot.birthEvents[i];
+				m_particles[i]->onBorn();
+			}
+			if (snapshot.deathEvents[i] != m_seenDeathEvents[i]) {
+				m_seenDeathEvents[i] = snapshot.deathEvents[i];
+				m_particles[i]->onDeath();
 			}
 		}
+
+		m_viewState = state;
+	}
+
+	//particle positions, interpolated between the last two steps:
+	const Snapshot& snapshot = m_snapshots.getReadBuffer();
+	if (m_particleBatch != nullptr) {
+		float alpha = m_interpolationAlpha;
+		if (m_simulationRunning.load(std::memory_order_relaxed) && snapshot.stepTime > 0) {
+			float elapsedTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.publishTime).count();
+			alpha = std::min(1.0f, elapsedTime / snapshot.stepTime);
+		}
+		if (snapshot.state.physicsPaused) {
+			//while paused, there are no steps to interpolate between
+			alpha = 1.0f;
+		}
+		m_particleBatch->setFrame(snapshot.particles.visible.empty() ? nullptr : &snapshot.particles, alpha);
+	}
+}
+
+void CasinoGame::startSimulationThread(float stepTime)
+{
+	if (!m_simulationRunning.load()) {
+		m_simulationRunning.store(true);
+		m_simulationThread = std::thread(&CasinoGame::simulationLoop, this, stepTime);
+	}
+}
+
+void CasinoGame::stopSimulationThread()
+{
+	m_simulationRunning.store(false);
+	if (m_simulationThread.joinable()) {
+		m_simulationThread.join();
 	}
 }
 
+ThreadTimer::Stats CasinoGame::getSimulationTimerStats() const
+{
+	return m_simulationTimer.getStats();
+}
+
+void CasinoGame::simulationLoop(float stepTime)
+{
+	Profiler::setThreadName("Simulation");
+	GameLoop gameLoop(stepTime);
+	while (m_simulationRunning.load()) {
+		gameLoop.beginFrame();
+		while (gameLoop.step()) {
+			updatePhysics(gameLoop.getStepTime());
+		}
+
+		//sleep until the next step is due
+		std::this_thread::sleep_for(std::chrono::duration<float>((1 - gameLoop.getAlpha()) * gameLoop.getStepTime()));
+	}
+}
+
+void CasinoGame::publishSnapshot(float stepTime)
+{
+	Snapshot& snapshot = m_snapshots.getWriteBuffer();
+	snapshot.state = m_currentState;
+	m_particleSystem->copyFrame(snapshot.particles);
+	snapshot.birthEvents = m_birthEvents;
+	snapshot.deathEvents = m_deathEvents;
+	snapshot.publishTime = std::chrono::steady_clock::now();
+	snapshot.stepTime = stepTime;
+	m_snapshots.publish();
+}
+
 void CasinoGame::addShapesToWindow()
 {
+	Profiler::Zone zone("CasinoGame::addShapesToWindow");
 	std::vector<std::pair<boost::shared_ptr<WindowInterface>, int>> orderedShapes;
 
 	for (const std::pair<const std::string, std::pair<boost::shared_ptr<WindowInterface>, int>>& shape : m_shapeMap) {
@@ -290,178 +684,59 @@ void CasinoGame::addShapesToWindow()
 		});
 
 	for (const std::pair <boost::shared_ptr<WindowInterface>, int>& shape : orderedShapes) {
-		m_currentWindow->addChild(shape.first);
+		m_currentWindow->addChild(shape.first, WindowModel::Layer(shape.second));
 	}
+
+	//background, frames, texts and buttons only change on a play, a credit or a hover, the particles above them every frame:
+	m_currentWindow->enableLayerCache(true, WindowModel::l2);
 }
 
-void CasinoGame::onStartButton(std::map<std::string, void*> argsMap)
+void CasinoGame::applyCommand(Command command)
 {
-	if (argsMap.count("trackValues") != 0) {//regen arg
-		State* statePtr = dynamic_cast<State*>((State*)argsMap["trackValues"]);
-		if (statePtr != nullptr) {
-
-			//toggle pause state, if play ongoing
-			if (statePtr->playOngoing) {
-				//pause/play behaviour
-				statePtr->physicsPaused = !statePtr->physicsPaused;
-
-				if (argsMap.count("currentButton") != 0) { //regen arg
-					ButtonShape* buttonPtr = dynamic_cast<ButtonShape*>((ButtonShape*)argsMap["currentButton"]);
-					if (buttonPtr != nullptr) {
-						if (statePtr->physicsPaused) {
-							buttonPtr->resetContent("START");
-						}
-						else {
-							buttonPtr->resetContent("PAUSE");
-						}
-					}
-				}
-			}
-
-			else if (statePtr->insertCount > 0) {
-				//start button behaviour
-				statePtr->insertCount--;//decrement value
-				statePtr->physicsPaused = false;
-
-				if (argsMap.count("textObject") != 0) { //regen arg
-					TextShape* textPtr = dynamic_cast<TextShape*>((TextShape*)argsMap["textObject"]);
-					if (textPtr != nullptr) {
-						//set value on view
-						textPtr->resetContent(std::to_string(statePtr->insertCount));
-					}
-				}
-
-				if (argsMap.count("particleMap") != 0) { //regen arg
-					std::map<std::string, boost::shared_ptr<ParticleInterface>>* particleMap =
-						dynamic_cast<std::map<std::string, boost::shared_ptr<ParticleInterface>>*>(
-							(std::map<std::string, boost::shared_ptr<ParticleInterface>>*)argsMap["particleMap"]);
-					if (particleMap != nullptr) {
-						//rebirth Objects
-						for (std::pair<std::string, boost::shared_ptr<ParticleInterface>> particlePair : *particleMap) {
-							particlePair.second->resetToBirthState();
-							particlePair.second->birth();
-						}
-					}
-				}
-
-				//issue the start of play, by setting start button to pause:
-				if (argsMap.count("currentButton") != 0) { //regen arg
-					ButtonShape* buttonPtr = dynamic_cast<ButtonShape*>((ButtonShape*)argsMap["currentButton"]);
-					if (buttonPtr != nullptr) {
-						buttonPtr->resetContent("PAUSE");
-						buttonPtr->swapTexture(BoxShape::Mask1);
-					}
-				}
-			}
+	switch (command) {
+	case Start:
+		//toggle pause state, if play ongoing
+		if (m_currentState.playOngoing) {
+			//pause/play behaviour
+			m_currentState.physicsPaused = !m_currentState.physicsPaused;
 		}
-	}
-}
-
-void CasinoGame::onCreditsInButton(std::map<std::string, void*> argsMap) {
-	if (argsMap.count("trackValues") != 0) {//regen arg
-		State* statePtr = dynamic_cast<State*>((State*)argsMap["trackValues"]);
-		if (statePtr != nullptr) {
-			statePtr->insertCount++;//increment value
-
-			if (argsMap.count("textObject") != 0) { //regen arg
-				TextShape* textPtr = dynamic_cast<TextShape*>((TextShape*)argsMap["textObject"]);
-				if (textPtr != nullptr) {
-					//set value on view
-					textPtr->resetContent(std::to_string(statePtr->insertCount));
-				}
-			}
+		else if (m_currentState.insertCount > 0) {
+			//start button behaviour
+			m_currentState.insertCount--;//decrement value
+			m_currentState.physicsPaused = false;
+			journalEvent(CreditJournal::PlayStarted);
+
+			//rebirth Objects, which starts the play
+			m_particleSystem->rebirthAll();
+			m_currentState.playOngoing = m_particleSystem->getAliveCount() > 0;
 		}
-	}
-}
-
-void CasinoGame::onCreditsOutButton(std::map<std::string, void*> argsMap) {
-	if (argsMap.count("trackValues") != 0) {//regen arg
-		State* statePtr = dynamic_cast<State*>((State*)argsMap["trackValues"]);
-		if (statePtr != nullptr) {
-			if (statePtr->insertCount > 0) {
-
-				statePtr->removeCount++;//increment value
-
-				if (argsMap.count("incrementObject") != 0) { //regen arg
-					TextShape* textPtr = dynamic_cast<TextShape*>((TextShape*)argsMap["incrementObject"]);
-					if (textPtr != nullptr) {
-						//set value on view
-						textPtr->resetContent(std::to_string(statePtr->removeCount));
-					}
-				}
-
-				statePtr->insertCount--;//decrement value
-
-				if (argsMap.count("decrementObject") != 0) { //regen arg
-					TextShape* textPtr = dynamic_cast<TextShape*>((TextShape*)argsMap["decrementObject"]);
-					if (textPtr != nullptr) {
-						//set value on view
-						textPtr->resetContent(std::to_string(statePtr->insertCount));
-					}
-				}
-			}
+		break;
+
+	case CreditsIn:
+		m_currentState.insertCount++;//increment value
+		journalEvent(CreditJournal::CreditInserted);
+		break;
+
+	case CreditsOut:
+		if (m_currentState.insertCount > 0) {
+			m_currentState.removeCount++;//increment value
+			m_currentState.insertCount--;//decrement value
+			journalEvent(CreditJournal::CreditRemoved);
 		}
+		break;
 	}
 }
 
-bool CasinoGame::particleDeathCondition(std::map<std::string, void*> argsMap)
+bool CasinoGame::particleDeathCondition(const ParticleSystem& particleSystem, ParticleSystem::Index index)
 {
-	bool killCurrentParticle = false;//by default, stay alive
-
-	if (argsMap.count("currentParticle") != 0) {//regen arg
-		ParticleInterface* particlePtr = dynamic_cast<ParticleInterface*>((ParticleInterface*)argsMap["currentParticle"]);
-		if (particlePtr != nullptr)
-		{
-			//check current particle state:
-			if (particlePtr->isAlive() && particlePtr->getState().position.x < 0.0f)
-			{
-				killCurrentParticle = true;//kill it
-			}
-
-			//on known deadth, check if play count should increment:
-			if (killCurrentParticle && argsMap.count("particleMap") != 0) { //regen arg
-				std::map<std::string, boost::shared_ptr<ParticleInterface>>* particleMap =
-					dynamic_cast<std::map<std::string, boost::shared_ptr<ParticleInterface>>*>(
-						(std::map<std::string, boost::shared_ptr<ParticleInterface>>*)argsMap["particleMap"]);
-				if (particleMap != nullptr) {
-					//check if particle objects are dead:
-					bool allParticlesAreDead = true;
-					for (std::pair<std::string, boost::shared_ptr<ParticleInterface>> particlePair : *particleMap) {
-						if (particlePair.second.get() != particlePtr && particlePair.second->isAlive()) {
-							allParticlesAreDead = false;
-						}
-					}
-
-					//update play count:
-					if (allParticlesAreDead) {
-						if (argsMap.count("trackValues") != 0) {//regen arg
-							State* statePtr = dynamic_cast<State*>((State*)argsMap["trackValues"]);
-							if (statePtr != nullptr) {
-								statePtr->playCount++;//increment value
-								if (argsMap.count("textObject") != 0) { //regen arg
-									TextShape* textPtr = dynamic_cast<TextShape*>((TextShape*)argsMap["textObject"]);
-									if (textPtr != nullptr) {
-										//set value on view
-										textPtr->resetContent(std::to_string(statePtr->playCount));
-									}
-								}
-							}
-						}
-
-						//issue the end of play, by setting start button to play:
-						if (argsMap.count("startButton") != 0) { //regen arg
-							ButtonShape* buttonPtr = dynamic_cast<ButtonShape*>((ButtonShape*)argsMap["startButton"]);
-							if (buttonPtr != nullptr) {
-								buttonPtr->resetContent("PLAY");
-								buttonPtr->swapTexture(BoxShape::Mask0);
-							}
-						}
-
-					}//else, do nothing
-				}
-			}
-		}
-	}
+	//kill the particles which left the window by the left side:
+	return particleSystem.getPosition(index).x < 0.0f;
+}
 
-	return killCurrentParticle;
-}
\ No newline at end of file
+void CasinoGame::onAllParticlesDead()
+{
+	//update play count, the views follow on the next snapshot:
+	m_currentState.playCount++;//increment value
+	m_currentState.playOngoing = false;
+	journalEvent(CreditJournal::PlayEnded);
+}
@@ -0,0 +1,381 @@
+/*****************************************************************
+ * \file	CreditJournal.cpp
+ * \brief	Functions and methods for class CreditJournal, to be used with CreditJournal.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "CreditJournal.hpp"
+#include "MathModule.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	const std::size_t recordSize = 16;
+	const std::size_t snapshotSize = 28;
+	const std::uint32_t snapshotMagic = 0x314a5343; //"CSJ1"
+
+	bool writeAll(int file, const unsigned char* data, std::size_t size)
+	{
+		while (size > 0) {
+			ssize_t written = ::write(file, data, size);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			data += written;
+			size -= std::size_t(written);
+		}
+		return true;
+	}
+
+	bool readAll(int file, unsigned char* data, std::size_t size)
+	{
+		while (size > 0) {
+			ssize_t bytesRead = ::read(file, data, size);
+			if (bytesRead < 0 && errno == EINTR) {
+				continue;
+			}
+			if (bytesRead <= 0) {
+				return false;
+			}
+			data += bytesRead;
+			size -= std::size_t(bytesRead);
+		}
+		return true;
+	}
+
+	void syncDirectory(const std::string& filePath)
+	{
+		//a rename is only durable once its directory is:
+		std::string::size_type slash = filePath.find_last_of('/');
+		std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filePath.substr(0, slash));
+		int file = ::open(directory.c_str(), O_RDONLY);
+		if (file >= 0) {
+			::fsync(file);
+			::close(file);
+		}
+	}
+}
+
+CreditJournal::CreditJournal(const std::string& path, std::size_t compactionInterval) :
+	m_journalPath(path + ".journal"),
+	m_snapshotPath(path + ".snapshot"),
+	m_compactionInterval(compactionInterval),
+	m_journalFile(-1),
+	m_durableSequence(0),
+	m_journalRecords(0),
+	m_nextSequence(1),
+	m_committedSequence(0),
+	m_compactionRequested(false),
+	m_compactionCount(0),
+	m_stopping(false)
+{
+	recover();
+	m_commitThread = std::thread(&CreditJournal::commitLoop, this);
+}
+
+CreditJournal::~CreditJournal()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wakeCondition.notify_one();
+	if (m_commitThread.joinable()) {
+		m_commitThread.join();
+	}
+	::close(m_journalFile);
+}
+
+CreditJournal::Counters CreditJournal::getCounters() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_counters;
+}
+
+void CreditJournal::append(Event event)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Record record;
+		record.sequence = m_nextSequence++;
+		record.event = event;
+		record.checksum = computeChecksum(record);
+		m_queuedRecords.push_back(record);
+		apply(m_counters, event);
+		m_stats.appended++;
+	}
+	m_wakeCondition.notify_one();
+}
+
+void CreditJournal::flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::uint64_t lastSequence = m_nextSequence - 1;
+	m_commitCondition.wait(lock, [this, lastSequence]() {
+		return m_committedSequence >= lastSequence;
+	});
+}
+
+void CreditJournal::compact()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::size_t compactionCount = m_compactionCount;
+	m_compactionRequested = true;
+	m_wakeCondition.notify_one();
+	m_commitCondition.wait(lock, [this, compactionCount]() {
+		return m_compactionCount != compactionCount;
+	});
+}
+
+CreditJournal::Stats CreditJournal::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void CreditJournal::apply(Counters& counters, Event event)
+{
+	switch (event) {
+	case CreditInserted:
+		counters.insertCount++;
+		break;
+
+	case CreditRemoved:
+		counters.removeCount++;
+		counters.insertCount--;
+		break;
+
+	case PlayStarted:
+		counters.insertCount--;
+		break;
+
+	case PlayEnded:
+		counters.playCount++;
+		break;
+	}
+}
+
+void CreditJournal::recover()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Counters counters;
+	std::uint64_t sequence = 0;
+
+	//snapshot: replaced atomically, so it is either missing or whole
+	int snapshotFile = ::open(m_snapshotPath.c_str(), O_RDONLY);
+	if (snapshotFile >= 0) {
+		unsigned char data[snapshotSize];
+		bool loaded = readAll(snapshotFile, data, snapshotSize);
+		::close(snapshotFile);
+
+		std::uint32_t magic = 0, checksum = 0;
+		if (loaded) {
+			std::memcpy(&magic, data, 4);
+			std::memcpy(&checksum, data + 24, 4);
+		}
+		if (!loaded || magic != snapshotMagic || checksum != MathModule::getChecksum(data, 24)) {
+			throw("CAN'T LOAD CREDIT SNAPSHOT");
+		}
+		std::memcpy(&sequence, data + 4, 8);
+		std::memcpy(&counters.playCount, data + 12, 4);
+		std::memcpy(&counters.insertCount, data + 16, 4);
+		std::memcpy(&counters.removeCount, data + 20, 4);
+	}
+	const std::uint64_t snapshotSequence = sequence;
+
+	m_journalFile = ::open(m_journalPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+	struct stat fileStatus;
+	if (m_journalFile < 0 || ::fstat(m_journalFile, &fileStatus) != 0) {
+		throw("CAN'T LOAD CREDIT JOURNAL");
+	}
+
+	//journal, read at once:
+	std::vector<unsigned char> data(std::size_t(fileStatus.st_size));
+	if (!data.empty() && (::lseek(m_journalFile, 0, SEEK_SET) != 0 || !readAll(m_journalFile, data.data(), data.size()))) {
+		throw("CAN'T LOAD CREDIT JOURNAL");
+	}
+
+	std::size_t validSize = 0;
+	std::size_t replayedRecords = 0;
+	for (; validSize + recordSize <= data.size(); validSize += recordSize) {
+		Record record;
+		std::memcpy(&record.sequence, &data[validSize], 8);
+		std::memcpy(&record.event, &data[validSize + 8], 4);
+		std::memcpy(&record.checksum, &data[validSize + 12], 4);
+
+		if (record.checksum != computeChecksum(record)) {
+			break;
+		}
+		if (record.sequence <= snapshotSequence) {
+			//already in the snapshot, the journal wasn't emptied yet
+			continue;
+		}
+		if (record.sequence != sequence + 1) {
+			break;
+		}
+		apply(counters, Event(record.event));
+		sequence = record.sequence;
+		replayedRecords++;
+	}
+
+	//a crash tears the end of the last batch written; anything valid past it is corruption, not a torn write:
+	if (validSize != data.size()) {
+		for (std::size_t offset = validSize + recordSize; offset + recordSize <= data.size(); offset += recordSize) {
+			Record record;
+			std::memcpy(&record.sequence, &data[offset], 8);
+			std::memcpy(&record.event, &data[offset + 8], 4);
+			std::memcpy(&record.checksum, &data[offset + 12], 4);
+			if (record.checksum == computeChecksum(record) && record.sequence > sequence) {
+				throw("CAN'T LOAD CREDIT JOURNAL");
+			}
+		}
+		if (::ftruncate(m_journalFile, off_t(validSize)) != 0 || ::fsync(m_journalFile) != 0) {
+			throw("CAN'T LOAD CREDIT JOURNAL");
+		}
+		m_stats.truncatedTail = true;
+	}
+
+	m_counters = counters;
+	m_durableCounters = counters;
+	m_durableSequence = sequence;
+	m_committedSequence = sequence;
+	m_nextSequence = sequence + 1;
+	m_journalRecords = validSize / recordSize;
+
+	m_stats.replayedRecords = replayedRecords;
+	m_stats.recoveryTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CreditJournal::writeSnapshot()
+{
+	unsigned char data[snapshotSize];
+	std::memcpy(data, &snapshotMagic, 4);
+	std::memcpy(data + 4, &m_durableSequence, 8);
+	std::memcpy(data + 12, &m_durableCounters.playCount, 4);
+	std::memcpy(data + 16, &m_durableCounters.insertCount, 4);
+	std::memcpy(data + 20, &m_durableCounters.removeCount, 4);
+	std::uint32_t checksum = MathModule::getChecksum(data, 24);
+	std::memcpy(data + 24, &checksum, 4);
+
+	//write aside, then replace the snapshot at once:
+	std::string temporaryPath = m_snapshotPath + ".tmp";
+	int file = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		std::cerr << "Credit journal: can't write " << temporaryPath << ".\n";
+		return;
+	}
+	bool written = writeAll(file, data, snapshotSize) && ::fsync(file) == 0;
+	::close(file);
+	if (!written || ::rename(temporaryPath.c_str(), m_snapshotPath.c_str()) != 0) {
+		std::cerr << "Credit journal: can't write " << m_snapshotPath << ".\n";
+		return;
+	}
+	syncDirectory(m_snapshotPath);
+
+	//the snapshot holds every record now, recovery skips them until the journal is emptied:
+	if (::ftruncate(m_journalFile, 0) == 0 && ::fsync(m_journalFile) == 0) {
+		m_journalRecords = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.compactions++;
+}
+
+void CreditJournal::commitLoop()
+{
+	std::vector<Record> batch;
+	std::vector<unsigned char> data;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wakeCondition.wait(lock, [this]() {
+			return m_stopping || m_compactionRequested || !m_queuedRecords.empty();
+		});
+		if (m_stopping && !m_compactionRequested && m_queuedRecords.empty()) {
+			break;
+		}
+
+		//every record queued meanwhile goes in this commit:
+		batch.swap(m_queuedRecords);
+		bool compactionRequested = m_compactionRequested;
+		m_compactionRequested = false;
+		lock.unlock();
+
+		bool committed = true;
+		if (!batch.empty()) {
+			data.resize(batch.size() * recordSize);
+			for (std::size_t i = 0; i < batch.size(); i++) {
+				std::memcpy(&data[i * recordSize], &batch[i].sequence, 8);
+				std::memcpy(&data[i * recordSize + 8], &batch[i].event, 4);
+				std::memcpy(&data[i * recordSize + 12], &batch[i].checksum, 4);
+			}
+			committed = writeAll(m_journalFile, data.data(), data.size()) && ::fdatasync(m_journalFile) == 0;
+
+			if (committed) {
+				for (const Record& record : batch) {
+					apply(m_durableCounters, Event(record.event));
+				}
+				m_durableSequence = batch.back().sequence;
+				m_journalRecords += batch.size();
+			}
+			else {
+				//drop what was partially written, and retry the batch:
+				std::cerr << "Credit journal: can't write " << m_journalPath << ", retrying.\n";
+				if (::ftruncate(m_journalFile, off_t(m_journalRecords * recordSize)) != 0) {
+					std::cerr << "Credit journal: can't truncate " << m_journalPath << ".\n";
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+		}
+
+		if (committed && (compactionRequested || (m_compactionInterval > 0 && m_journalRecords >= m_compactionInterval))) {
+			writeSnapshot();
+		}
+
+		lock.lock();
+		if (committed) {
+			m_stats.committed += batch.size();
+			m_stats.commits += batch.empty() ? 0 : 1;
+			m_committedSequence = m_durableSequence;
+			batch.clear();
+		}
+		else if (m_stopping) {
+			std::cerr << "Credit journal: " << batch.size() + m_queuedRecords.size() << " events lost.\n";
+			break;
+		}
+		else {
+			batch.insert(batch.end(), m_queuedRecords.begin(), m_queuedRecords.end());
+			m_queuedRecords.swap(batch);
+			batch.clear();
+		}
+		if (compactionRequested) {
+			if (committed) {
+				m_compactionCount++;
+			}
+			else {
+				m_compactionRequested = true;
+			}
+		}
+		m_commitCondition.notify_all();
+	}
+}
+
+std::uint32_t CreditJournal::computeChecksum(const Record& record)
+{
+	unsigned char data[12];
+	std::memcpy(data, &record.sequence, 8);
+	std::memcpy(data + 8, &record.event, 4);
+	return MathModule::getChecksum(data, 12);
+}
@@ -0,0 +1,96 @@
+/*****************************************************************
+ * \file	GameLoop.cpp
+ * \brief	Functions and methods for class GameLoop, to be used with GameLoop.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "GameLoop.hpp"
+
+GameLoop::GameLoop(float stepTime, float maxFrameTime, float metricsWindow) :
+	m_stepTime(stepTime),
+	m_maxFrameTime(maxFrameTime),
+	m_metricsWindow(metricsWindow),
+	m_accumulator(0),
+	m_started(false),
+	m_windowSteps(0),
+	m_windowFrames(0)
+{
+}
+
+float GameLoop::beginFrame()
+{
+	Clock::time_point now = Clock::now();
+	if (!m_started) {
+		//first frame, nothing to simulate yet
+		m_previousFrame = now;
+		m_windowStart = now;
+		m_started = true;
+	}
+
+	float frameTime = std::chrono::duration<float>(now - m_previousFrame).count();
+	m_previousFrame = now;
+	return accumulate(now, frameTime);
+}
+
+float GameLoop::beginFrame(float frameTime)
+{
+	Clock::time_point now = Clock::now();
+	if (!m_started) {
+		m_windowStart = now;
+		m_started = true;
+	}
+	m_previousFrame = now;
+	return accumulate(now, frameTime);
+}
+
+float GameLoop::accumulate(Clock::time_point now, float frameTime)
+{
+	//avoid the spiral of death, by dropping the simulation time that can't be caught up with:
+	if (frameTime > m_maxFrameTime) {
+		frameTime = m_maxFrameTime;
+		m_metrics.clampedFrames++;
+	}
+	m_accumulator += frameTime;
+
+	//close the metrics window:
+	m_windowFrames++;
+	float windowTime = std::chrono::duration<float>(now - m_windowStart).count();
+	if (windowTime >= m_metricsWindow) {
+		m_metrics.stepRate = m_windowSteps / windowTime;
+		m_metrics.renderRate = m_windowFrames / windowTime;
+		m_windowSteps = 0;
+		m_windowFrames = 0;
+		m_windowStart = now;
+	}
+
+	return frameTime;
+}
+
+bool GameLoop::step()
+{
+	if (m_accumulator < m_stepTime) {
+		return false;
+	}
+	m_accumulator -= m_stepTime;
+	m_windowSteps++;
+	return true;
+}
+
+float GameLoop::getStepTime() const
+{
+	return m_stepTime;
+}
+
+float GameLoop::getAlpha() const
+{
+	return float(m_accumulator / m_stepTime);
+}
+
+GameLoop::Metrics GameLoop::getMetrics() const
+{
+	Metrics metrics = m_metrics;
+	metrics.lag = float(m_accumulator);
+	return metrics;
+}
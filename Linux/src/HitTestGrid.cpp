@@ -0,0 +1,155 @@
+/*****************************************************************
+ * \file	HitTestGrid.cpp
+ * \brief	Functions and methods for class HitTestGrid, to be used with HitTestGrid.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "HitTestGrid.hpp"
+#include "ButtonInterface.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+HitTestGrid::HitTestGrid(const sf::Vector2f& areaSize, float cellSize) :
+	m_cellSize(cellSize > 0 ? cellSize : 64),
+	m_dispatchMark(0)
+{
+	m_gridSize.x = std::max(1, int(std::ceil(areaSize.x / m_cellSize)));
+	m_gridSize.y = std::max(1, int(std::ceil(areaSize.y / m_cellSize)));
+	m_cells.resize(std::size_t(m_gridSize.x) * m_gridSize.y);
+}
+
+void HitTestGrid::add(boost::shared_ptr<ButtonInterface> button)
+{
+	if (button == nullptr) {
+		return;
+	}
+	Entry entry;
+	entry.button = button;
+	entry.bounds = button->getHitBounds();
+	entry.mark = 0;
+	m_entries.push_back(entry);
+
+	const std::uint32_t index = std::uint32_t(m_entries.size() - 1);
+	const sf::Vector2i first = getCell({ entry.bounds.left, entry.bounds.top });
+	const sf::Vector2i last = getCell({ entry.bounds.left + entry.bounds.width, entry.bounds.top + entry.bounds.height });
+	for (int y = first.y; y <= last.y; y++) {
+		for (int x = first.x; x <= last.x; x++) {
+			m_cells[std::size_t(y) * m_gridSize.x + x].push_back(index);
+		}
+	}
+}
+
+void HitTestGrid::remove(const boost::shared_ptr<ButtonInterface>& button)
+{
+	std::vector<ButtonInterface*> hovered;
+	for (std::uint32_t index : m_hovered) {
+		if (m_entries[index].button.get() != button.get()) {
+			hovered.push_back(m_entries[index].button.get());
+		}
+	}
+
+	const std::size_t count = m_entries.size();
+	m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+		[&button](const Entry& entry) { return entry.button.get() == button.get(); }), m_entries.end());
+
+	//the indices moved, rare enough to list every button again (the hovered ones keep seeing the mouse leave):
+	if (m_entries.size() != count) {
+		rebuildCells();
+		m_hovered.clear();
+		for (std::uint32_t index = 0; index < m_entries.size(); index++) {
+			if (std::find(hovered.begin(), hovered.end(), m_entries[index].button.get()) != hovered.end()) {
+				m_hovered.push_back(index);
+			}
+		}
+	}
+}
+
+void HitTestGrid::dispatch(sf::RenderWindow* window, const sf::Event& evnt)
+{
+	m_stats.events++;
+	m_dispatchMark++;
+	m_targets.clear();
+
+	//the coordinates of the mouse events, the others reach every button:
+	sf::Vector2f position;
+	switch (evnt.type) {
+	case sf::Event::MouseMoved:
+		position = sf::Vector2f(float(evnt.mouseMove.x), float(evnt.mouseMove.y));
+		break;
+	case sf::Event::MouseButtonPressed:
+	case sf::Event::MouseButtonReleased:
+		position = sf::Vector2f(float(evnt.mouseButton.x), float(evnt.mouseButton.y));
+		break;
+	case sf::Event::MouseWheelScrolled:
+		position = sf::Vector2f(float(evnt.mouseWheelScroll.x), float(evnt.mouseWheelScroll.y));
+		break;
+	default:
+		for (Entry& entry : m_entries) {
+			entry.button->onWindowEvent(window, evnt);
+			m_stats.deliveries++;
+		}
+		return;
+	}
+
+	//the buttons the mouse was over, so that they see it leave, then the ones it is over
+	//(bounds edges included, the buttons test their own bounds):
+	for (std::uint32_t index : m_hovered) {
+		addTarget(index);
+	}
+	m_hovered.clear();
+	const sf::Vector2i cell = getCell(position);
+	for (std::uint32_t index : m_cells[std::size_t(cell.y) * m_gridSize.x + cell.x]) {
+		const sf::FloatRect& bounds = m_entries[index].bounds;
+		if (bounds.left <= position.x && position.x <= bounds.left + bounds.width &&
+			bounds.top <= position.y && position.y <= bounds.top + bounds.height) {
+			m_hovered.push_back(index);
+			addTarget(index);
+		}
+	}
+
+	std::sort(m_targets.begin(), m_targets.end());
+	for (std::uint32_t index : m_targets) {
+		m_entries[index].button->onWindowEvent(window, evnt);
+		m_stats.deliveries++;
+	}
+}
+
+std::size_t HitTestGrid::getButtonCount() const
+{
+	return m_entries.size();
+}
+
+const HitTestGrid::Stats& HitTestGrid::getStats() const
+{
+	return m_stats;
+}
+
+sf::Vector2i HitTestGrid::getCell(const sf::Vector2f& position) const
+{
+	const int x = int(std::floor(position.x / m_cellSize));
+	const int y = int(std::floor(position.y / m_cellSize));
+	return sf::Vector2i(std::max(0, std::min(m_gridSize.x - 1, x)), std::max(0, std::min(m_gridSize.y - 1, y)));
+}
+
+void HitTestGrid::rebuildCells()
+{
+	std::vector<Entry> entries;
+	entries.swap(m_entries);
+	for (std::vector<std::uint32_t>& cell : m_cells) {
+		cell.clear();
+	}
+	for (const Entry& entry : entries) {
+		add(entry.button);
+	}
+}
+
+void HitTestGrid::addTarget(std::uint32_t index)
+{
+	if (m_entries[index].mark != m_dispatchMark) {
+		m_entries[index].mark = m_dispatchMark;
+		m_targets.push_back(index);
+	}
+}
@@ -0,0 +1,42 @@
+/*****************************************************************
+ * \file	InputSnapshot.cpp
+ * \brief	Functions and methods for class InputSnapshot, to be used with InputSnapshot.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "InputSnapshot.hpp"
+
+InputSnapshot::InputSnapshot()
+{
+}
+
+void InputSnapshot::beginFrame()
+{
+	m_events.clear();
+	m_stats.frames++;
+}
+
+void InputSnapshot::addEvent(const sf::Event& evnt)
+{
+	m_stats.events++;
+
+	//only the last of consecutive moves, nothing happened in between:
+	if (evnt.type == sf::Event::MouseMoved && !m_events.empty() && m_events.back().type == sf::Event::MouseMoved) {
+		m_events.back() = evnt;
+		m_stats.coalescedMoves++;
+		return;
+	}
+	m_events.push_back(evnt);
+}
+
+const std::vector<sf::Event>& InputSnapshot::getEvents() const
+{
+	return m_events;
+}
+
+const InputSnapshot::Stats& InputSnapshot::getStats() const
+{
+	return m_stats;
+}
@@ -0,0 +1,212 @@
+/*****************************************************************
+ * \file	JobSystem.cpp
+ * \brief	Functions and methods for class JobSystem, to be used with JobSystem.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+
+#include <string>
+
+JobSystem::JobSystem() :
+	m_queuedTasks(0),
+	m_stopping(false)
+{
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	startWorkers(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+}
+
+JobSystem::~JobSystem()
+{
+	stopWorkers();
+}
+
+JobSystem& JobSystem::getInstance()
+{
+	static JobSystem instance;
+	return instance;
+}
+
+void JobSystem::setWorkerCount(std::size_t workers)
+{
+	JobSystem& instance = getInstance();
+	instance.stopWorkers();
+	instance.startWorkers(workers);
+}
+
+std::size_t JobSystem::getWorkerCount()
+{
+	return getInstance().m_workers.size();
+}
+
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const RangeJob& job)
+{
+	if (end <= begin) {
+		return;
+	}
+
+	JobSystem& instance = getInstance();
+	if (grainSize == 0) {
+		grainSize = 1;
+	}
+
+	//not worth splitting:
+	if (instance.m_workers.empty() || end - begin <= grainSize) {
+		job(begin, end);
+		return;
+	}
+
+	//deal the subranges round robin between the workers:
+	std::size_t taskCount = (end - begin + grainSize - 1) / grainSize;
+	std::atomic<std::size_t> remaining(taskCount);
+	std::size_t workerIndex = 0;
+	for (std::size_t first = begin; first < end; first += grainSize) {
+		Task task;
+		task.job = &job;
+		task.begin = first;
+		task.end = (end - first > grainSize) ? first + grainSize : end;
+		task.remaining = &remaining;
+
+		Worker& worker = *instance.m_workers[workerIndex];
+		{
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.tasks.push_back(task);
+		}
+		workerIndex = (workerIndex + 1) % instance.m_workers.size();
+	}
+	instance.m_queuedTasks.fetch_add(taskCount);
+	{
+		std::lock_guard<std::mutex> lock(instance.m_wakeMutex);
+	}
+	instance.m_wakeCondition.notify_all();
+
+	//help, instead of waiting idle:
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		Task task;
+		if (instance.takeTask(instance.m_workers.size(), task)) {
+			runTask(task);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+std::vector<JobSystem::WorkerStats> JobSystem::getWorkerStats()
+{
+	JobSystem& instance = getInstance();
+	ThreadTimer::Clock::time_point now = ThreadTimer::Clock::now();
+
+	std::vector<WorkerStats> workerStats;
+	for (const boost::shared_ptr<Worker>& worker : instance.m_workers) {
+		ThreadTimer::Stats timerStats = worker->timer.getStats();
+		double lifeTime = std::chrono::duration<double>(now - worker->startTime).count();
+
+		WorkerStats stats;
+		stats.tasks = timerStats.iterations;
+		stats.stolen = worker->stolen.load();
+		stats.busyTime = timerStats.busyTime;
+		stats.utilization = lifeTime > 0 ? timerStats.busyTime / lifeTime : 0;
+		workerStats.push_back(stats);
+	}
+	return workerStats;
+}
+
+void JobSystem::startWorkers(std::size_t workers)
+{
+	m_stopping = false;
+	for (std::size_t i = 0; i < workers; i++) {
+		boost::shared_ptr<Worker> worker(new Worker);
+		worker->stolen = 0;
+		worker->startTime = ThreadTimer::Clock::now();
+		m_workers.push_back(worker);
+	}
+	//start the threads once every queue exists, as they steal from each other:
+	for (std::size_t i = 0; i < workers; i++) {
+		m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+	}
+}
+
+void JobSystem::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_stopping = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (const boost::shared_ptr<Worker>& worker : m_workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	m_workers.clear();
+}
+
+void JobSystem::workerLoop(std::size_t index)
+{
+	Profiler::setThreadName("Job worker " + std::to_string(index));
+
+	Worker& worker = *m_workers[index];
+	while (true) {
+		Task task;
+		if (takeTask(index, task)) {
+			worker.timer.begin();
+			runTask(task);
+			worker.timer.end();
+			continue;
+		}
+
+		//sleep until there are tasks queued, or the pool stops:
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return m_stopping || m_queuedTasks.load() > 0; });
+		if (m_stopping) {
+			return;
+		}
+	}
+}
+
+bool JobSystem::takeTask(std::size_t index, Task& task)
+{
+	//newest task of the own queue:
+	if (index < m_workers.size()) {
+		Worker& worker = *m_workers[index];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (!worker.tasks.empty()) {
+			task = worker.tasks.back();
+			worker.tasks.pop_back();
+			m_queuedTasks.fetch_sub(1);
+			return true;
+		}
+	}
+
+	//otherwise steal the oldest task of another queue:
+	for (std::size_t offset = 1; offset <= m_workers.size(); offset++) {
+		std::size_t victimIndex = (index + offset) % m_workers.size();
+		if (victimIndex == index) {
+			continue;
+		}
+		Worker& victim = *m_workers[victimIndex];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			m_queuedTasks.fetch_sub(1);
+			if (index < m_workers.size()) {
+				m_workers[index]->stolen.fetch_add(1);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::runTask(const Task& task)
+{
+	Profiler::Zone zone("JobSystem::task");
+	(*task.job)(task.begin, task.end);
+	task.remaining->fetch_sub(1, std::memory_order_release);
+}
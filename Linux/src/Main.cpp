@@ -9,47 +9,463 @@
 #include "WindowManager.hpp"
 #include "CasinoGame.hpp"
 #include "WindowModel.hpp"
+#include "ResourceManager.hpp"
+#include "SoundPool.hpp"
+#include "GameLoop.hpp"
+#include "ThreadTimer.hpp"
+#include "JobSystem.hpp"
+#include "MathModule.hpp"
+#include "Profiler.hpp"
+#include "CreditJournal.hpp"
+#include "SnapshotFile.hpp"
+#include "SessionRecording.hpp"
+#include "HitTestGrid.hpp"
+#include "InputSnapshot.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
-int main() {
+/**
+ * @brief Function which prints the cost of the play snapshots.
+ * @param aCasinoGame The game.
+ */
+void printSnapshotStats(const CasinoGame& aCasinoGame)
+{
+	if (aCasinoGame.getPlaySnapshots() != nullptr) {
+		SnapshotFile::Stats snapshotStats = aCasinoGame.getPlaySnapshots()->getStats();
+		std::cout << "Play snapshots: " << snapshotStats.written << " written, " << snapshotStats.getAverageWriteTime() * 1e6 << " us/snapshot ("
+			<< snapshotStats.maxWriteTime * 1e6 << " us max), " << snapshotStats.coalesced << " coalesced while syncing, "
+			<< (snapshotStats.synced > 0 ? snapshotStats.syncTime / snapshotStats.synced * 1000 : 0) << " ms/sync.\n";
+	}
+}
+
+/**
+ * @brief Function which runs the game logic without window, as fast as the CPU allows, with scripted inputs:
+ * each play inserts two credits, removes one, starts, pauses and resumes once, and runs until every particle died.
+ * @param plays The number of plays to run.
+ * @param stepTime The fixed physics step, in seconds.
+ * @param journalPath The path of the credit journal, empty to not persist the credits.
+ * @param snapshotPath The path of the play snapshot file, empty to not snapshot the play.
+ * @param kinematics How the particles move.
+ * @return The exit code, 0 if every play ended.
+ */
+int runHeadless(unsigned int plays, float stepTime, const std::string& journalPath, const std::string& snapshotPath,
+	ParticleSystem::Kinematics kinematics)
+{
+	CasinoGame aCasinoGame(sf::Vector2u(800, 600));
+	aCasinoGame.setKinematics(kinematics);
+	if (!journalPath.empty()) {
+		aCasinoGame.openCreditJournal(journalPath);
+	}
+	if (!snapshotPath.empty()) {
+		aCasinoGame.openPlaySnapshots(snapshotPath);
+	}
+	aCasinoGame.init();
+
+	//a play that doesn't end in ten simulated minutes is stuck:
+	const unsigned long long maxStepsPerPlay = (unsigned long long)(600 / stepTime);
+	unsigned long long steps = 0;
+	bool stuck = false;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int play = 0; play < plays && !stuck; play++) {
+		aCasinoGame.issueCommand(CasinoGame::CreditsIn);
+		aCasinoGame.issueCommand(CasinoGame::CreditsIn);
+		aCasinoGame.issueCommand(CasinoGame::CreditsOut);
+		aCasinoGame.issueCommand(CasinoGame::Start);
+
+		unsigned int playCount = aCasinoGame.getState().playCount;
+		unsigned long long playSteps = 0;
+		while (aCasinoGame.getState().playCount == playCount) {
+			if (playSteps == 30 || playSteps == 31) {
+				aCasinoGame.issueCommand(CasinoGame::Start); //pause, then resume
+			}
+			aCasinoGame.updatePhysics(stepTime);
+			playSteps++;
+
+			if (playSteps > maxStepsPerPlay) {
+				stuck = true;
+				break;
+			}
+		}
+		steps += playSteps;
+	}
+	double elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const CasinoGame::State& state = aCasinoGame.getState();
+	std::cout << "Headless: " << state.playCount << " plays, " << steps << " steps (" << steps * stepTime << " s simulated) in "
+		<< elapsedTime << " s.\n";
+	if (elapsedTime > 0) {
+		std::cout << "Headless: " << steps / elapsedTime << " simulated frames/s, " << state.playCount / elapsedTime << " plays/s.\n";
+	}
+	std::cout << "Headless: random seed " << MathModule::getRandomSeed() << ".\n";
+	std::cout << "Headless: credits " << state.insertCount << " inserted, " << state.removeCount << " removed.\n";
+	if (aCasinoGame.getCreditJournal() != nullptr) {
+		aCasinoGame.getCreditJournal()->flush();
+		CreditJournal::Stats journalStats = aCasinoGame.getCreditJournal()->getStats();
+		std::cout << "Credit journal: " << journalStats.replayedRecords << " records replayed in " << journalStats.recoveryTime * 1000 << " ms, "
+			<< journalStats.committed << " events in " << journalStats.commits << " commits, " << journalStats.compactions << " compactions.\n";
+	}
+	printSnapshotStats(aCasinoGame);
+
+	if (stuck) {
+		std::cout << "Headless: play " << state.playCount + 1 << " didn't end.\n";
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Function which handles a window event, live or replayed: the buttons, closing the window and the profiler toggle (F9).
+ * @param aCasinoGame The game.
+ * @param evnt The event.
+ * @param tracePath The path the profiler trace is saved to.
+ */
+void handleWindowEvent(CasinoGame& aCasinoGame, const sf::Event& evnt, const std::string& tracePath)
+{
+	aCasinoGame.updateButtonsOnWindowEvent(evnt);
+
+	switch (evnt.type) {
+	case sf::Event::Closed:
+		aCasinoGame.getCurrentWindow()->close();
+		break;
+
+	case sf::Event::KeyPressed:
+		//toggle the profiler capture, saved once it stops:
+		if (evnt.key.code == sf::Keyboard::F9) {
+			Profiler::setEnabled(!Profiler::isEnabled());
+			if (!Profiler::isEnabled()) {
+				std::cout << "Profiler: " << Profiler::saveChromeTrace(tracePath) << " zones saved to " << tracePath << ".\n";
+				Profiler::clear();
+			}
+		}
+		break;
+	}
+}
+
+/**
+ * @brief Function which prints the distribution of the frame times.
+ * @param frameTimes The frame times, in seconds, sorted.
+ */
+void printFrameTimes(std::vector<float>& frameTimes)
+{
+	if (frameTimes.empty()) {
+		return;
+	}
+	std::sort(frameTimes.begin(), frameTimes.end());
+	double totalTime = 0;
+	for (float frameTime : frameTimes) {
+		totalTime += frameTime;
+	}
+	const std::size_t last = frameTimes.size() - 1;
+	std::cout << "Frame times: " << frameTimes.size() << " frames, " << totalTime / frameTimes.size() * 1000 << " ms mean, "
+		<< frameTimes[last / 2] * 1000 << " ms p50, " << frameTimes[last * 90 / 100] * 1000 << " ms p90, "
+		<< frameTimes[last * 99 / 100] * 1000 << " ms p99, " << frameTimes[last] * 1000 << " ms max.\n";
+}
+
+int main(int argc, char* argv[]) {
 
 	std::cout << "'ACasinoGame' has started!\n";
 
-	//window init:
+	//run the physics on a dedicated thread, with --threaded, and on N job workers, with --workers N,
+	//or only the game logic, without window, for N plays, with --headless N, and seed the random generators with --seed N,
+	//and capture the profiler zones from the start, to FILE, with --profile FILE (F9 toggles the capture at runtime),
+	//and persist the credits to the journal at PATH with --journal PATH, and the play in flight to the file at PATH
+	//with --snapshot PATH (headless runs only persist them with these), and move the particles with --kinematics euler|analytic (euler by default),
+	//and record the session (seed, frame times and window events) to FILE with --record FILE, or replay it with --replay FILE,
+	//without frame rate limit with --unthrottled (a recorded session starts a fresh play, and runs the physics on the window thread),
+	//and draw every layer every frame, instead of caching the static ones, with --no-layer-cache:
+	bool threaded = false;
+	bool unthrottled = false;
+	bool layerCache = true;
+	std::string recordPath;
+	std::string replayPath;
+	ParticleSystem::Kinematics kinematics = ParticleSystem::Euler;
+	unsigned int headlessPlays = 0;
+	std::string tracePath = "ACasinoGameTrace.json";
+	std::string journalPath;
+	std::string snapshotPath;
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--threaded") {
+			threaded = true;
+		}
+		else if (std::string(argv[i]) == "--headless" && i + 1 < argc) {
+			headlessPlays = std::stoul(argv[++i]);
+		}
+		else if (std::string(argv[i]) == "--seed" && i + 1 < argc) {
+			MathModule::setRandomSeed(std::stoull(argv[++i]));
+		}
+		else if (std::string(argv[i]) == "--workers" && i + 1 < argc) {
+			JobSystem::setWorkerCount(std::stoul(argv[++i]));
+		}
+		else if (std::string(argv[i]) == "--journal" && i + 1 < argc) {
+			journalPath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--snapshot" && i + 1 < argc) {
+			snapshotPath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--kinematics" && i + 1 < argc) {
+			kinematics = std::string(argv[++i]) == "analytic" ? ParticleSystem::Analytic : ParticleSystem::Euler;
+		}
+		else if (std::string(argv[i]) == "--record" && i + 1 < argc) {
+			recordPath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--replay" && i + 1 < argc) {
+			replayPath = argv[++i];
+		}
+		else if (std::string(argv[i]) == "--unthrottled") {
+			unthrottled = true;
+		}
+		else if (std::string(argv[i]) == "--no-layer-cache") {
+			layerCache = false;
+		}
+		else if (std::string(argv[i]) == "--profile" && i + 1 < argc) {
+			tracePath = argv[++i];
+			Profiler::setEnabled(true);
+		}
+	}
+	Profiler::setThreadName("Main");
+
 	int fps = 60;
-	float deltaTimeS = 1 / float(fps);
+	int physicsRate = 60; //may be lower than fps, rendering interpolates between steps
+	if (headlessPlays > 0) {
+		int exitCode = runHeadless(headlessPlays, 1 / float(physicsRate), journalPath, snapshotPath, kinematics);
+		if (Profiler::isEnabled()) {
+			std::cout << "Profiler: " << Profiler::saveChromeTrace(tracePath) << " zones saved to " << tracePath << ".\n";
+		}
+		return exitCode;
+	}
+
+	//a replayed session starts from what it was recorded with, and leaves the credits and the play on disk alone:
+	boost::shared_ptr<SessionRecording> recording;
+	float stepTime = 1 / float(physicsRate);
+	if (!replayPath.empty()) {
+		recording = boost::shared_ptr<SessionRecording>(new SessionRecording(replayPath));
+		MathModule::setRandomSeed(recording->getHeader().seed);
+		stepTime = recording->getHeader().stepTime;
+		kinematics = ParticleSystem::Kinematics(recording->getHeader().kinematics);
+	}
+	if (recording != nullptr || !recordPath.empty()) {
+		threaded = false;
+	}
+
+	//window init:
 	WindowManager::createWindow("A Casino Game", sf::Vector2u(800, 600), fps, "MyResources/Icons/aCasinoGame.png");
 	boost::shared_ptr<WindowModel> windowModel = WindowManager::getWindowModel("A Casino Game");
+	if (unthrottled) {
+		windowModel->setFramerateLimit(0);
+		windowModel->setVerticalSyncEnabled(false);
+	}
 
-	//game init
+	//game init, with the credits of the last run:
 	CasinoGame aCasinoGame(windowModel);
+	if (recording != nullptr) {
+		const SessionRecording::Header& header = recording->getHeader();
+		aCasinoGame.setInitialState(CasinoGame::State(header.playCount, header.insertCount, header.removeCount, false, false));
+	}
+	else {
+		aCasinoGame.openCreditJournal(journalPath.empty() ? "ACasinoGameCredits" : journalPath);
+		if (recordPath.empty()) {
+			aCasinoGame.openPlaySnapshots(snapshotPath.empty() ? "ACasinoGamePlay.snapshot" : snapshotPath);
+		}
+	}
+	aCasinoGame.setKinematics(kinematics);
 	aCasinoGame.init();
+	if (!layerCache) {
+		windowModel->enableLayerCache(false);
+	}
+
+	if (aCasinoGame.getCreditJournal() != nullptr) {
+		CreditJournal::Stats journalStats = aCasinoGame.getCreditJournal()->getStats();
+		std::cout << "Credit journal: " << journalStats.replayedRecords << " records replayed in " << journalStats.recoveryTime * 1000 << " ms"
+			<< (journalStats.truncatedTail ? ", torn tail truncated.\n" : ".\n");
+	}
+
+	if (!recordPath.empty()) {
+		SessionRecording::Header header;
+		header.seed = MathModule::getRandomSeed();
+		header.stepTime = stepTime;
+		header.kinematics = std::uint32_t(kinematics);
+		header.playCount = aCasinoGame.getState().playCount;
+		header.insertCount = aCasinoGame.getState().insertCount;
+		header.removeCount = aCasinoGame.getState().removeCount;
+		recording = boost::shared_ptr<SessionRecording>(new SessionRecording(recordPath, header));
+	}
+	const bool replaying = recording != nullptr && recording->isReplaying();
+
+	ResourceManager::Stats textureStats = ResourceManager::getTextureStats();
+	std::cout << "Textures: " << textureStats.resident << " resident (" << textureStats.bytesResident / 1024 << " KB), "
+		<< textureStats.hits << " hits, " << textureStats.misses << " misses.\n";
+	ResourceManager::Stats soundStats = ResourceManager::getSoundBufferStats();
+	std::cout << "Sound buffers: " << soundStats.resident << " resident (" << soundStats.bytesResident / 1024 << " KB), "
+		<< soundStats.hits << " hits, " << soundStats.misses << " misses, on " << SoundPool::getStats().voices << " voices.\n";
+	ResourceManager::Stats fontStats = ResourceManager::getFontStats();
+	std::cout << "Fonts: " << fontStats.resident << " resident, " << fontStats.glyphPages << " glyph pages (" << fontStats.bytesResident / 1024 << " KB), "
+		<< fontStats.hits << " hits, " << fontStats.misses << " misses.\n";
+
+	//Game Loop, physics run on fixed steps of measured time:
+	GameLoop gameLoop(stepTime);
+	ThreadTimer renderTimer;
+	std::vector<sf::Event> replayedEvents;
+	InputSnapshot input;
+	std::vector<float> frameTimes;
+	std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+	bool replayEnded = false;
+	if (threaded) {
+		aCasinoGame.startSimulationThread(gameLoop.getStepTime());
+	}
 
-	//Game Loop:
 	while (aCasinoGame.getCurrentWindow()->isOpen())
 	{
-		//update physics on window
-		aCasinoGame.updatePhysics(deltaTimeS);
+		//a replayed frame takes the recorded time and events, a recorded one saves them:
+		if (replaying) {
+			float frameTime = 0;
+			if (!recording->replayFrame(frameTime, replayedEvents)) {
+				replayEnded = true;
+				break;
+			}
+			gameLoop.beginFrame(frameTime);
+
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			frameTimes.push_back(std::chrono::duration<float>(now - frameStart).count());
+			frameStart = now;
+		}
+		else {
+			float frameTime = gameLoop.beginFrame();
+			if (recording != nullptr) {
+				recording->recordFrame(frameTime);
+			}
+		}
+		renderTimer.begin();
 
-		sf::Event evnt;
-		while (aCasinoGame.getCurrentWindow()->pollEvent(evnt))
 		{
-			aCasinoGame.updateButtonsOnWindowEvent(evnt);
+			Profiler::Zone zone("events");
+			//the queue is drained into the input of the frame, then handled at once, the mouse moves coalesced:
+			input.beginFrame();
+			sf::Event evnt;
+			while (aCasinoGame.getCurrentWindow()->pollEvent(evnt))
+			{
+				//the live input is ignored while replaying, except closing the window, which stops the replay:
+				if (replaying) {
+					if (evnt.type == sf::Event::Closed) {
+						windowModel->close();
+					}
+					continue;
+				}
+				if (recording != nullptr) {
+					recording->recordEvent(evnt);
+				}
+				input.addEvent(evnt);
+			}
+			for (const sf::Event& replayedEvent : replayedEvents) {
+				input.addEvent(replayedEvent);
+			}
+			for (const sf::Event& inputEvent : input.getEvents()) {
+				handleWindowEvent(aCasinoGame, inputEvent, tracePath);
+			}
+		}
 
-			switch (evnt.type) {
-			case sf::Event::Closed:
-				windowModel->close();
-				break;
+		//update physics on window, unless they run on their own thread
+		while (gameLoop.step()) {
+			if (!threaded) {
+				aCasinoGame.updatePhysics(gameLoop.getStepTime());
 			}
 		}
+		aCasinoGame.setInterpolationAlpha(gameLoop.getAlpha());
+		aCasinoGame.syncViews();
 
 		//update window:
-		aCasinoGame.getCurrentWindow()->clear(); //clear render
-		aCasinoGame.getCurrentWindow()->drawChildren(); //draw loaded children
-		aCasinoGame.getCurrentWindow()->display(); //rasterize to render
+		{
+			Profiler::Zone zone("clear");
+			aCasinoGame.getCurrentWindow()->clear(); //clear render
+		}
+		{
+			Profiler::Zone zone("drawChildren");
+			aCasinoGame.getCurrentWindow()->drawChildren(); //draw loaded children
+		}
+		renderTimer.end(); //display waits for the frame rate limit
+		{
+			Profiler::Zone zone("display");
+			aCasinoGame.getCurrentWindow()->display(); //rasterize to render
+		}
+	}
+	aCasinoGame.stopSimulationThread();
+
+	if (recording != nullptr) {
+		SessionRecording::Result result;
+		result.playCount = aCasinoGame.getState().playCount;
+		result.insertCount = aCasinoGame.getState().insertCount;
+		result.removeCount = aCasinoGame.getState().removeCount;
+		result.checksum = aCasinoGame.getSimulationChecksum();
+
+		if (!replaying) {
+			recording->recordEnd(result);
+			std::cout << "Recording: session saved to " << recordPath << ".\n";
+		}
+		else {
+			//the window closed on the last frame, the end of the session follows it:
+			float frameTime = 0;
+			replayEnded = replayEnded || !recording->replayFrame(frameTime, replayedEvents);
+
+			SessionRecording::Result recordedResult;
+			result.frames = frameTimes.size();
+			if (!replayEnded) {
+				std::cout << "Replay: stopped after " << result.frames << " frames.\n";
+			}
+			else if (!recording->getRecordedResult(recordedResult)) {
+				std::cout << "Replay: " << result.frames << " frames, the recording was interrupted, nothing to compare with.\n";
+			}
+			else {
+				std::cout << "Replay: " << result.frames << " frames, " << (result == recordedResult ? "reproduced" : "DIVERGED from")
+					<< " the recorded session (plays " << result.playCount << "/" << recordedResult.playCount
+					<< ", checksum " << std::hex << result.checksum << "/" << recordedResult.checksum << std::dec << ").\n";
+			}
+			printFrameTimes(frameTimes);
+		}
+	}
+
+	if (Profiler::isEnabled()) {
+		std::cout << "Profiler: " << Profiler::saveChromeTrace(tracePath) << " zones saved to " << tracePath << ".\n";
+	}
+
+	GameLoop::Metrics loopMetrics = gameLoop.getMetrics();
+	std::cout << "Loop: " << loopMetrics.stepRate << " steps/s, " << loopMetrics.renderRate << " frames/s, "
+		<< loopMetrics.lag * 1000 << " ms lag, " << loopMetrics.clampedFrames << " clamped frames.\n";
+
+	ThreadTimer::Stats simulationStats = aCasinoGame.getSimulationTimerStats();
+	ThreadTimer::Stats renderStats = renderTimer.getStats();
+	std::cout << "Simulation" << (threaded ? " thread: " : ": ") << simulationStats.iterations << " steps, "
+		<< simulationStats.getAverageTime() * 1000 << " ms/step, " << simulationStats.getUtilization() * 100 << "% busy.\n";
+	std::cout << "Render" << (threaded ? " thread: " : ": ") << renderStats.iterations << " frames, "
+		<< renderStats.getAverageTime() * 1000 << " ms/frame, " << renderStats.getUtilization() * 100 << "% busy.\n";
+	std::cout << "Layer cache: " << windowModel->getLayerCacheRedrawCount() << " redraws.\n";
+	RenderQueue::Stats queueStats = windowModel->getRenderQueue().getTotalStats();
+	RenderQueue::Stats lastFrameStats = windowModel->getRenderQueue().getFrameStats();
+	if (queueStats.frames > 0) {
+		std::cout << "Render queue: " << double(queueStats.draws) / queueStats.frames << " draws/frame, "
+			<< double(queueStats.binds) / queueStats.frames << " texture binds/frame (last frame " << lastFrameStats.draws << " draws, "
+			<< lastFrameStats.binds << " binds).\n";
+	}
+	InputSnapshot::Stats inputStats = input.getStats();
+	std::cout << "Input: " << inputStats.events << " events over " << inputStats.frames << " frames, "
+		<< inputStats.coalescedMoves << " mouse moves coalesced.\n";
+	if (aCasinoGame.getHitTestGrid() != nullptr) {
+		HitTestGrid::Stats hitTestStats = aCasinoGame.getHitTestGrid()->getStats();
+		std::cout << "Hit test: " << hitTestStats.events << " events, " << hitTestStats.deliveries << " deliveries to "
+			<< aCasinoGame.getHitTestGrid()->getButtonCount() << " buttons.\n";
+	}
+
+	printSnapshotStats(aCasinoGame);
+
+	std::vector<JobSystem::WorkerStats> workerStats = JobSystem::getWorkerStats();
+	for (std::size_t i = 0; i < workerStats.size(); i++) {
+		std::cout << "Job worker " << i << ": " << workerStats[i].tasks << " tasks (" << workerStats[i].stolen << " stolen), "
+			<< workerStats[i].utilization * 100 << "% busy.\n";
 	}
 
 	std::cout << "'ACasinoGame' has quit gracefully.\n";
@@ -7,24 +7,64 @@
 ******************************************************************/
 
 #include "MathModule.hpp"
-#include <chrono>
-#include <cstdlib>
+#include "RandomEngine.hpp"
 
-const long long MathModule::m_ramdomizationSeed = MathModule::generateSeed();
+namespace {
+	struct Crc32Table {
+		//slicing by 8: values[k][b] is the crc of byte b followed by k zero bytes
+		std::uint32_t values[8][256];
 
-long long MathModule::generateSeed() {
-	//use time to generate random seed:
-	auto timeNow = std::chrono::steady_clock::now();
-	long long timeNowValue =
-		std::chrono::duration_cast<std::chrono::microseconds>(timeNow.time_since_epoch()).count();
-	std::srand((unsigned int)(timeNowValue));
-
-	return timeNowValue;
+		Crc32Table()
+		{
+			for (std::uint32_t i = 0; i < 256; i++) {
+				std::uint32_t value = i;
+				for (int bit = 0; bit < 8; bit++) {
+					value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+				}
+				values[0][i] = value;
+			}
+			for (std::uint32_t i = 0; i < 256; i++) {
+				for (int k = 1; k < 8; k++) {
+					values[k][i] = (values[k - 1][i] >> 8) ^ values[0][values[k - 1][i] & 0xff];
+				}
+			}
+		}
+	};
 }
 
 float MathModule::getRandom(float lowestInterval, float highestInterval) {
+	return RandomEngine::getThreadEngine().uniform(lowestInterval, highestInterval);
+}
+
+void MathModule::fillRandom(float* values, std::size_t count, float lowestInterval, float highestInterval) {
+	RandomEngine::getThreadEngine().fillUniform(values, count, lowestInterval, highestInterval);
+}
+
+void MathModule::setRandomSeed(std::uint64_t seed) {
+	RandomEngine::setGlobalSeed(seed);
+}
+
+std::uint64_t MathModule::getRandomSeed() {
+	return RandomEngine::getGlobalSeed();
+}
+
+std::uint32_t MathModule::getChecksum(const void* data, std::size_t size) {
+	static const Crc32Table table;
 
-	int random = std::rand() / ((RAND_MAX) / 100); //value [0 100]
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	std::uint32_t crc = 0xffffffffu;
 
-	return (lowestInterval + 0.01f * random * (highestInterval - lowestInterval));
+	//8 bytes per step (little endian):
+	for (; size >= 8; size -= 8, bytes += 8) {
+		std::uint32_t low = crc ^ (std::uint32_t(bytes[0]) | std::uint32_t(bytes[1]) << 8 | std::uint32_t(bytes[2]) << 16 | std::uint32_t(bytes[3]) << 24);
+		std::uint32_t high = std::uint32_t(bytes[4]) | std::uint32_t(bytes[5]) << 8 | std::uint32_t(bytes[6]) << 16 | std::uint32_t(bytes[7]) << 24;
+		crc = table.values[7][low & 0xff] ^ table.values[6][(low >> 8) & 0xff] ^
+			table.values[5][(low >> 16) & 0xff] ^ table.values[4][low >> 24] ^
+			table.values[3][high & 0xff] ^ table.values[2][(high >> 8) & 0xff] ^
+			table.values[1][(high >> 16) & 0xff] ^ table.values[0][high >> 24];
+	}
+	for (; size > 0; size--, bytes++) {
+		crc = table.values[0][(crc ^ *bytes) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffffu;
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*****************************************************************
+ * \file	ParticleBatch.cpp
+ * \brief	Functions and methods for class ParticleBatch, to be used with ParticleBatch.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "ParticleBatch.hpp"
+#include "PolyParticleShape.hpp"
+
+ParticleBatch::ParticleBatch() :
+	m_frame(nullptr),
+	m_alpha(1),
+	m_vertices(sf::Triangles)
+{
+}
+
+void ParticleBatch::addParticle(const PolyParticleShape& particle)
+{
+	if (m_meshes.empty()) {
+		m_texture = particle.getTexture();
+	}
+	else if (particle.getTexture() != m_texture) {
+		throw(std::string("PARTICLE BATCH TEXTURE MISMATCH"));
+	}
+
+	Mesh mesh;
+	mesh.index = particle.getIndex();
+	mesh.firstVertex = m_localVertices.size();
+	mesh.vertexCount = particle.appendLocalTriangles(m_localVertices);
+	m_meshes.push_back(mesh);
+}
+
+void ParticleBatch::setFrame(const ParticleSystem::Frame* frame, float alpha)
+{
+	m_frame = frame;
+	m_alpha = alpha;
+}
+
+std::size_t ParticleBatch::getVertexCount() const
+{
+	return m_vertices.getVertexCount();
+}
+
+void ParticleBatch::drawTo(sf::RenderTarget* target)
+{
+	if (target == nullptr || m_frame == nullptr) {
+		return;
+	}
+
+	//worst case size, so that the vertex array is only reallocated once:
+	m_vertices.resize(m_localVertices.size());
+
+	std::size_t vertexCount = 0;
+	for (const Mesh& mesh : m_meshes) {
+		//only render if is alive
+		if (m_frame->visible[mesh.index]) {
+			sf::Vector2f position = m_frame->getInterpolatedPosition(mesh.index, m_alpha);
+			for (std::size_t i = 0; i < mesh.vertexCount; i++) {
+				sf::Vertex& vertex = m_vertices[vertexCount++];
+				vertex = m_localVertices[mesh.firstVertex + i];
+				vertex.position += position;
+			}
+		}
+	}
+	m_vertices.resize(vertexCount);
+
+	if (vertexCount > 0) {
+		target->draw(m_vertices, sf::RenderStates(m_texture.get()));
+	}
+}
+
+const sf::Texture* ParticleBatch::getDrawPassTexture(std::size_t /*pass*/) const
+{
+	return m_texture.get();
+}
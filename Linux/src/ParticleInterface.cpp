@@ -7,29 +7,67 @@
 ******************************************************************/
 
 #include "ParticleInterface.hpp"
-#include "CustomSound.hpp"
+#include "SoundEffect.hpp"
 
-ParticleInterface::ParticleInterface() :
-	p_isAlive(false),
+ParticleInterface::ParticleInterface(boost::shared_ptr<ParticleSystem> system) :
+	p_system(system),
+	p_index(system->addParticle()),
 	p_birthSound(nullptr),
 	p_birthSoundActive(false),
 	p_deathSound(nullptr),
-	p_deathSoundActive(false),
-	p_deathCondition(nullptr)
+	p_deathSoundActive(false)
 {
 }
 
-void ParticleInterface::setDeathCondition(bool (*callback)(std::map<std::string, void*>), const std::map<std::string, void*>& argsMap) {
-	p_deathCondition = callback;
-	p_deathConditionArgsMap = argsMap;
+void ParticleInterface::setBirthState(const State& state, float timeOfBirth)
+{
+	p_system->setBirthState(p_index, state, timeOfBirth);
+}
+
+void ParticleInterface::setResetState(const State& state) {
+	p_system->setResetState(p_index, state);
+}
+
+void ParticleInterface::resetToBirthState() {
+	p_system->resetToBirthState(p_index);
+}
+
+void ParticleInterface::birth()
+{
+	p_system->birth(p_index);
+}
+
+void ParticleInterface::onBorn()
+{
+	//birth sound, played when it is born:
+	if (p_birthSound != nullptr && p_birthSoundActive) {
+		p_birthSound->play();
+	}
+}
+
+void ParticleInterface::death() {
+	p_system->kill(p_index);//first thing
+	onDeath();
+}
+
+void ParticleInterface::onDeath()
+{
+	//death sound:
+	if (p_deathSound != nullptr && p_deathSoundActive) {
+		p_deathSound->play();
+	}
 }
 
 bool ParticleInterface::isAlive() const {
-	return p_isAlive;
+	return p_system->isAlive(p_index);
+}
+
+bool ParticleInterface::isVisible() const {
+	return p_system->isVisible(p_index);
 }
 
 void ParticleInterface::setBirthSound(const std::string& path, bool activate) {
-	p_birthSound.reset(new CustomSound(path));
+	p_birthSound.reset(new SoundEffect(path, SoundPool::Low));
 	if (activate) {
 		enableBirthSound(activate);
 	}
@@ -40,7 +78,7 @@ void ParticleInterface::enableBirthSound(bool enable) {
 }
 
 void ParticleInterface::setDeathSound(const std::string& path, bool activate) {
-	p_deathSound.reset(new CustomSound(path));
+	p_deathSound.reset(new SoundEffect(path, SoundPool::Low));
 	if (activate) {
 		enableDeathSound(activate);
 	}
@@ -52,5 +90,10 @@ void ParticleInterface::enableDeathSound(bool enable) {
 
 ParticleInterface::State ParticleInterface::getState() const
 {
-	return p_state;
+	return p_system->getState(p_index);
+}
+
+ParticleSystem::Index ParticleInterface::getIndex() const
+{
+	return p_index;
 }
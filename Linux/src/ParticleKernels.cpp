@@ -0,0 +1,180 @@
+/*****************************************************************
+ * \file	ParticleKernels.cpp
+ * \brief	Functions and methods for class ParticleKernels, to be used with ParticleKernels.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "ParticleKernels.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define PARTICLE_KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define PARTICLE_KERNELS_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace {
+
+	//note: the multiply and the add are kept as two roundings on every path (no fma),
+	//so all the instruction sets give the same results as the scalar integrator.
+	void integrateEulerScalar(const ParticleKernels::Arrays& arrays, std::size_t begin, std::size_t end, float deltaTime)
+	{
+		for (std::size_t i = begin; i < end; i++) {
+			if (arrays.active[i]) {
+				arrays.velocityX[i] += deltaTime * arrays.accelerationX[i];
+				arrays.velocityY[i] += deltaTime * arrays.accelerationY[i];
+				arrays.positionX[i] += deltaTime * arrays.velocityX[i];
+				arrays.positionY[i] += deltaTime * arrays.velocityY[i];
+			}
+		}
+	}
+
+#ifdef PARTICLE_KERNELS_SSE2
+	inline __m128 selectSSE2(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	void integrateEulerSSE2(const ParticleKernels::Arrays& arrays, std::size_t begin, std::size_t end, float deltaTime)
+	{
+		const __m128 dt = _mm_set1_ps(deltaTime);
+		const __m128i zero = _mm_setzero_si128();
+
+		std::size_t i = begin;
+		for (; i + 4 <= end; i += 4) {
+			std::int32_t flags;
+			std::memcpy(&flags, arrays.active + i, sizeof(flags));
+			if (flags == 0) {
+				continue;//no active particle on this block
+			}
+
+			//widen the 4 flag bytes into 4 lane masks:
+			__m128i lanes = _mm_cvtsi32_si128(flags);
+			lanes = _mm_unpacklo_epi8(lanes, zero);
+			lanes = _mm_unpacklo_epi16(lanes, zero);
+			const __m128 mask = _mm_castsi128_ps(_mm_cmpgt_epi32(lanes, zero));
+
+			__m128 velocityX = _mm_loadu_ps(arrays.velocityX + i);
+			__m128 velocityY = _mm_loadu_ps(arrays.velocityY + i);
+			__m128 positionX = _mm_loadu_ps(arrays.positionX + i);
+			__m128 positionY = _mm_loadu_ps(arrays.positionY + i);
+
+			velocityX = selectSSE2(mask, _mm_add_ps(velocityX, _mm_mul_ps(dt, _mm_loadu_ps(arrays.accelerationX + i))), velocityX);
+			velocityY = selectSSE2(mask, _mm_add_ps(velocityY, _mm_mul_ps(dt, _mm_loadu_ps(arrays.accelerationY + i))), velocityY);
+			positionX = selectSSE2(mask, _mm_add_ps(positionX, _mm_mul_ps(dt, velocityX)), positionX);
+			positionY = selectSSE2(mask, _mm_add_ps(positionY, _mm_mul_ps(dt, velocityY)), positionY);
+
+			_mm_storeu_ps(arrays.velocityX + i, velocityX);
+			_mm_storeu_ps(arrays.velocityY + i, velocityY);
+			_mm_storeu_ps(arrays.positionX + i, positionX);
+			_mm_storeu_ps(arrays.positionY + i, positionY);
+		}
+
+		integrateEulerScalar(arrays, i, end, deltaTime);
+	}
+#endif
+
+#ifdef PARTICLE_KERNELS_AVX2
+	__attribute__((target("avx2")))
+	void integrateEulerAVX2(const ParticleKernels::Arrays& arrays, std::size_t begin, std::size_t end, float deltaTime)
+	{
+		const __m256 dt = _mm256_set1_ps(deltaTime);
+		const __m256i zero = _mm256_setzero_si256();
+
+		std::size_t i = begin;
+		for (; i + 8 <= end; i += 8) {
+			std::int64_t flags;
+			std::memcpy(&flags, arrays.active + i, sizeof(flags));
+			if (flags == 0) {
+				continue;//no active particle on this block
+			}
+
+			//widen the 8 flag bytes into 8 lane masks:
+			const __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(arrays.active + i)));
+			const __m256 mask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(lanes, zero));
+
+			__m256 velocityX = _mm256_loadu_ps(arrays.velocityX + i);
+			__m256 velocityY = _mm256_loadu_ps(arrays.velocityY + i);
+			__m256 positionX = _mm256_loadu_ps(arrays.positionX + i);
+			__m256 positionY = _mm256_loadu_ps(arrays.positionY + i);
+
+			velocityX = _mm256_blendv_ps(velocityX, _mm256_add_ps(velocityX, _mm256_mul_ps(dt, _mm256_loadu_ps(arrays.accelerationX + i))), mask);
+			velocityY = _mm256_blendv_ps(velocityY, _mm256_add_ps(velocityY, _mm256_mul_ps(dt, _mm256_loadu_ps(arrays.accelerationY + i))), mask);
+			positionX = _mm256_blendv_ps(positionX, _mm256_add_ps(positionX, _mm256_mul_ps(dt, velocityX)), mask);
+			positionY = _mm256_blendv_ps(positionY, _mm256_add_ps(positionY, _mm256_mul_ps(dt, velocityY)), mask);
+
+			_mm256_storeu_ps(arrays.velocityX + i, velocityX);
+			_mm256_storeu_ps(arrays.velocityY + i, velocityY);
+			_mm256_storeu_ps(arrays.positionX + i, positionX);
+			_mm256_storeu_ps(arrays.positionY + i, positionY);
+		}
+
+		integrateEulerScalar(arrays, i, end, deltaTime);
+	}
+#endif
+}
+
+ParticleKernels::InstructionSet ParticleKernels::m_instructionSet = ParticleKernels::getSupportedInstructionSet();
+
+void ParticleKernels::integrateEuler(const Arrays& arrays, std::size_t begin, std::size_t end, float deltaTime)
+{
+	switch (m_instructionSet) {
+#ifdef PARTICLE_KERNELS_AVX2
+	case AVX2:
+		integrateEulerAVX2(arrays, begin, end, deltaTime);
+		break;
+#endif
+#ifdef PARTICLE_KERNELS_SSE2
+	case SSE2:
+		integrateEulerSSE2(arrays, begin, end, deltaTime);
+		break;
+#endif
+	default:
+		integrateEulerScalar(arrays, begin, end, deltaTime);
+		break;
+	}
+}
+
+ParticleKernels::InstructionSet ParticleKernels::getInstructionSet()
+{
+	return m_instructionSet;
+}
+
+void ParticleKernels::setInstructionSet(InstructionSet instructionSet)
+{
+	InstructionSet supported = getSupportedInstructionSet();
+	m_instructionSet = (instructionSet > supported) ? supported : instructionSet;
+}
+
+ParticleKernels::InstructionSet ParticleKernels::getSupportedInstructionSet()
+{
+#if defined(PARTICLE_KERNELS_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		return AVX2;
+	}
+	return SSE2;
+#elif defined(PARTICLE_KERNELS_SSE2)
+	return SSE2;
+#else
+	return Scalar;
+#endif
+}
+
+const char* ParticleKernels::getInstructionSetName(InstructionSet instructionSet)
+{
+	switch (instructionSet) {
+	case AVX2:
+		return "AVX2";
+	case SSE2:
+		return "SSE2";
+	default:
+		return "Scalar";
+	}
+}
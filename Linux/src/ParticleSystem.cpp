@@ -0,0 +1,579 @@
+/*****************************************************************
+ * \file	ParticleSystem.cpp
+ * \brief	Functions and methods for class ParticleSystem, to be used with ParticleSystem.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "ParticleSystem.hpp"
+#include "ParticleKernels.hpp"
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+	template <typename T>
+	void writeArray(unsigned char*& data, const std::vector<T>& values)
+	{
+		if (!values.empty()) {
+			std::memcpy(data, values.data(), values.size() * sizeof(T));
+		}
+		data += values.size() * sizeof(T);
+	}
+
+	template <typename T>
+	void readArray(const unsigned char*& data, std::vector<T>& values)
+	{
+		if (!values.empty()) {
+			std::memcpy(values.data(), data, values.size() * sizeof(T));
+		}
+		data += values.size() * sizeof(T);
+	}
+}
+
+sf::Vector2f ParticleSystem::Frame::getInterpolatedPosition(Index index, float alpha) const
+{
+	return {
+		previousPositionX[index] + (positionX[index] - previousPositionX[index]) * alpha,
+		previousPositionY[index] + (positionY[index] - previousPositionY[index]) * alpha
+	};
+}
+
+ParticleSystem::ParticleSystem() :
+	m_kinematics(Euler),
+	m_hasDeathBoundary(false),
+	m_deathBoundaryNormal(0, 0),
+	m_deathBoundaryOffset(0),
+	m_clock(0),
+	m_parallelGrainSize(4096),
+	m_interpolationAlpha(1),
+	m_aliveCount(0)
+{
+}
+
+void ParticleSystem::reserve(std::size_t capacity)
+{
+	m_positionX.reserve(capacity);
+	m_positionY.reserve(capacity);
+	m_previousPositionX.reserve(capacity);
+	m_previousPositionY.reserve(capacity);
+	m_velocityX.reserve(capacity);
+	m_velocityY.reserve(capacity);
+	m_accelerationX.reserve(capacity);
+	m_accelerationY.reserve(capacity);
+	m_timeOfBirth.reserve(capacity);
+	m_launchTime.reserve(capacity);
+	m_birthTimer.reserve(capacity);
+	m_deathTimer.reserve(capacity);
+	m_alive.reserve(capacity);
+	m_visible.reserve(capacity);
+	m_dying.reserve(capacity);
+	m_resetState.reserve(capacity);
+	m_launched.reserve(capacity);
+	m_deathTime.reserve(capacity);
+	m_bornParticles.reserve(capacity);
+	m_diedParticles.reserve(capacity);
+	m_dueDeaths.reserve(capacity);
+}
+
+ParticleSystem::Index ParticleSystem::addParticle()
+{
+	m_positionX.push_back(0);
+	m_positionY.push_back(0);
+	m_previousPositionX.push_back(0);
+	m_previousPositionY.push_back(0);
+	m_velocityX.push_back(0);
+	m_velocityY.push_back(0);
+	m_accelerationX.push_back(0);
+	m_accelerationY.push_back(0);
+	m_timeOfBirth.push_back(0);
+	m_launchTime.push_back(0);
+	m_birthTimer.push_back(0);
+	m_deathTimer.push_back(0);
+	m_alive.push_back(0);
+	m_visible.push_back(0);
+	m_dying.push_back(0);
+	m_resetState.push_back(State());
+	m_launched.push_back(0);
+	m_deathTime.push_back(std::numeric_limits<float>::infinity());
+
+	return m_positionX.size() - 1;
+}
+
+std::size_t ParticleSystem::getParticleCount() const
+{
+	return m_positionX.size();
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+	m_bornParticles.clear();
+	m_diedParticles.clear();
+
+	//the births, and predicted deaths, due by the end of the step fire (the deaths are applied after the step):
+	m_clock += deltaTime;
+	m_timers.advance(m_clock);
+
+	const std::size_t count = m_positionX.size();
+
+	//keep the positions before the step, to be interpolated when rendering
+	m_previousPositionX = m_positionX;
+	m_previousPositionY = m_positionY;
+
+	if (m_kinematics == Analytic && count > 0) {
+		//closed form trajectories, of the visible particles
+		ParticleSystem* system = this;
+		JobSystem::parallelFor(0, count, m_parallelGrainSize, JobSystem::RangeJob::fromFunctor(
+			[system](std::size_t begin, std::size_t end) {
+				system->evaluateTrajectories(begin, end);
+			}));
+	}
+	else if (count > 0) {
+		//euler integration, of the visible particles, in bulk
+		ParticleKernels::Arrays arrays;
+		arrays.positionX = m_positionX.data();
+		arrays.positionY = m_positionY.data();
+		arrays.velocityX = m_velocityX.data();
+		arrays.velocityY = m_velocityY.data();
+		arrays.accelerationX = m_accelerationX.data();
+		arrays.accelerationY = m_accelerationY.data();
+		arrays.active = m_visible.data();
+
+		const ParticleKernels::Arrays* arraysPtr = &arrays;
+		JobSystem::parallelFor(0, count, m_parallelGrainSize, JobSystem::RangeJob::fromFunctor(
+			[arraysPtr, deltaTime](std::size_t begin, std::size_t end) {
+				ParticleKernels::integrateEuler(*arraysPtr, begin, end, deltaTime);
+			}));
+	}
+
+	if (isDeathPredicted()) {
+		//predicted deaths, killed in order
+		std::sort(m_dueDeaths.begin(), m_dueDeaths.end());
+		for (Index index : m_dueDeaths) {
+			if (m_alive[index]) {
+				m_diedParticles.push_back(index);
+				kill(index);
+			}
+		}
+		m_dueDeaths.clear();
+	}
+	else if (m_deathCondition && count > 0) {
+		//death condition, of the visible particles, flagged in parallel and killed in order
+		ParticleSystem* system = this;
+		JobSystem::parallelFor(0, count, m_parallelGrainSize, JobSystem::RangeJob::fromFunctor(
+			[system](std::size_t begin, std::size_t end) {
+				system->flagDying(begin, end);
+			}));
+
+		for (std::size_t i = 0; i < count; i++) {
+			if (m_dying[i]) {
+				m_diedParticles.push_back(i);
+				kill(i);
+			}
+		}
+	}
+}
+
+void ParticleSystem::setParallelGrainSize(std::size_t grainSize)
+{
+	m_parallelGrainSize = grainSize < 8 ? 8 : (grainSize + 7) / 8 * 8;
+}
+
+void ParticleSystem::setKinematics(Kinematics kinematics)
+{
+	m_kinematics = kinematics;
+	rescheduleAll();
+}
+
+ParticleSystem::Kinematics ParticleSystem::getKinematics() const
+{
+	return m_kinematics;
+}
+
+void ParticleSystem::setDeathBoundary(const sf::Vector2f& normal, float offset)
+{
+	m_hasDeathBoundary = true;
+	m_deathBoundaryNormal = normal;
+	m_deathBoundaryOffset = offset;
+
+	for (Index i = 0; i < m_positionX.size(); i++) {
+		solveDeathTime(i);
+	}
+	rescheduleAll();
+}
+
+float ParticleSystem::getBirthTime(Index index) const
+{
+	return m_timeOfBirth[index];
+}
+
+float ParticleSystem::getDeathTime(Index index) const
+{
+	return m_timeOfBirth[index] + m_deathTime[index];
+}
+
+bool ParticleSystem::seek(float time)
+{
+	if (m_kinematics != Analytic) {
+		return false;
+	}
+
+	m_bornParticles.clear();
+	m_diedParticles.clear();
+
+	const std::size_t aliveCount = m_aliveCount;
+	const std::size_t count = m_positionX.size();
+	m_aliveCount = 0;
+	for (std::size_t i = 0; i < count; i++) {
+		if (!m_launched[i]) {
+			m_aliveCount += m_alive[i];
+			continue;
+		}
+
+		//without a death boundary the death time isn't known, the particle stays as it was
+		m_launchTime[i] = m_clock - time;
+		if (m_hasDeathBoundary) {
+			m_alive[i] = time < getDeathTime(i);
+		}
+		m_visible[i] = m_alive[i] && time >= m_timeOfBirth[i];
+		m_aliveCount += m_alive[i];
+
+		writeState(i, m_resetState[i]);
+	}
+	rescheduleAll();
+
+	//place the visible particles, without interpolating across the jump
+	ParticleSystem* system = this;
+	JobSystem::parallelFor(0, count, m_parallelGrainSize, JobSystem::RangeJob::fromFunctor(
+		[system](std::size_t begin, std::size_t end) {
+			system->evaluateTrajectories(begin, end);
+		}));
+	m_previousPositionX = m_positionX;
+	m_previousPositionY = m_positionY;
+
+	if (aliveCount > 0 && m_aliveCount == 0 && m_allDeadCallback) {
+		m_allDeadCallback();
+	}
+	return true;
+}
+
+void ParticleSystem::setBirthState(Index index, const State& state, float timeOfBirth)
+{
+	writeState(index, state);
+	m_timeOfBirth[index] = timeOfBirth;
+	m_resetState[index] = state;
+	solveDeathTime(index);
+	scheduleParticle(index);
+}
+
+void ParticleSystem::setResetState(Index index, const State& state)
+{
+	m_resetState[index] = state;
+	solveDeathTime(index);
+	scheduleParticle(index);
+}
+
+void ParticleSystem::resetToBirthState(Index index)
+{
+	writeState(index, m_resetState[index]);
+}
+
+void ParticleSystem::birth(Index index)
+{
+	m_launchTime[index] = m_clock;//reset lifetime
+	m_visible[index] = 0;
+	m_launched[index] = 1;
+	if (!m_alive[index]) {
+		m_aliveCount++;
+	}
+	m_alive[index] = 1;
+	scheduleParticle(index);//last thing
+}
+
+void ParticleSystem::kill(Index index)
+{
+	m_visible[index] = 0;
+	if (m_alive[index]) {
+		m_alive[index] = 0;
+		m_aliveCount--;
+		scheduleParticle(index);//cancel its timers
+
+		//the last one, raise the event once:
+		if (m_aliveCount == 0 && m_allDeadCallback) {
+			m_allDeadCallback();
+		}
+	}
+}
+
+void ParticleSystem::rebirthAll()
+{
+	for (Index i = 0; i < m_positionX.size(); i++) {
+		resetToBirthState(i);
+		birth(i);
+	}
+}
+
+bool ParticleSystem::isAlive(Index index) const
+{
+	return m_alive[index] != 0;
+}
+
+bool ParticleSystem::isVisible(Index index) const
+{
+	return m_visible[index] != 0;
+}
+
+std::size_t ParticleSystem::getAliveCount() const
+{
+	return m_aliveCount;
+}
+
+void ParticleSystem::setDeathCondition(const DeathCondition& condition)
+{
+	m_deathCondition = condition;
+}
+
+void ParticleSystem::setAllDeadCallback(const Delegate<void()>& callback)
+{
+	m_allDeadCallback = callback;
+}
+
+ParticleSystem::State ParticleSystem::getState(Index index) const
+{
+	State state;
+	state.position = { m_positionX[index], m_positionY[index] };
+	state.velocity = { m_velocityX[index], m_velocityY[index] };
+	state.acceleration = { m_accelerationX[index], m_accelerationY[index] };
+	return state;
+}
+
+sf::Vector2f ParticleSystem::getPosition(Index index) const
+{
+	return { m_positionX[index], m_positionY[index] };
+}
+
+void ParticleSystem::setInterpolationAlpha(float alpha)
+{
+	m_interpolationAlpha = alpha;
+}
+
+sf::Vector2f ParticleSystem::getInterpolatedPosition(Index index) const
+{
+	return {
+		m_previousPositionX[index] + (m_positionX[index] - m_previousPositionX[index]) * m_interpolationAlpha,
+		m_previousPositionY[index] + (m_positionY[index] - m_previousPositionY[index]) * m_interpolationAlpha
+	};
+}
+
+void ParticleSystem::copyFrame(Frame& frame) const
+{
+	frame.previousPositionX = m_previousPositionX;
+	frame.previousPositionY = m_previousPositionY;
+	frame.positionX = m_positionX;
+	frame.positionY = m_positionY;
+	frame.visible = m_visible;
+}
+
+std::size_t ParticleSystem::getSnapshotSize() const
+{
+	//count and clock, 9 float arrays, the launch times, the reset states and 3 flag arrays:
+	const std::size_t count = m_positionX.size();
+	return sizeof(std::uint64_t) + sizeof(double) + count * (9 * sizeof(float) + sizeof(double) + sizeof(State) + 3);
+}
+
+void ParticleSystem::writeSnapshot(unsigned char* data) const
+{
+	std::uint64_t count = m_positionX.size();
+	std::memcpy(data, &count, sizeof(count));
+	data += sizeof(count);
+	std::memcpy(data, &m_clock, sizeof(m_clock));
+	data += sizeof(m_clock);
+
+	writeArray(data, m_positionX);
+	writeArray(data, m_positionY);
+	writeArray(data, m_previousPositionX);
+	writeArray(data, m_previousPositionY);
+	writeArray(data, m_velocityX);
+	writeArray(data, m_velocityY);
+	writeArray(data, m_accelerationX);
+	writeArray(data, m_accelerationY);
+	writeArray(data, m_timeOfBirth);
+	writeArray(data, m_launchTime);
+	writeArray(data, m_resetState);
+	writeArray(data, m_alive);
+	writeArray(data, m_visible);
+	writeArray(data, m_launched);
+}
+
+bool ParticleSystem::readSnapshot(const unsigned char* data, std::size_t size)
+{
+	std::uint64_t count = 0;
+	if (size != getSnapshotSize()) {
+		return false;
+	}
+	std::memcpy(&count, data, sizeof(count));
+	if (count != m_positionX.size()) {
+		return false;
+	}
+	data += sizeof(count);
+	std::memcpy(&m_clock, data, sizeof(m_clock));
+	data += sizeof(m_clock);
+
+	readArray(data, m_positionX);
+	readArray(data, m_positionY);
+	readArray(data, m_previousPositionX);
+	readArray(data, m_previousPositionY);
+	readArray(data, m_velocityX);
+	readArray(data, m_velocityY);
+	readArray(data, m_accelerationX);
+	readArray(data, m_accelerationY);
+	readArray(data, m_timeOfBirth);
+	readArray(data, m_launchTime);
+	readArray(data, m_resetState);
+	readArray(data, m_alive);
+	readArray(data, m_visible);
+	readArray(data, m_launched);
+
+	m_aliveCount = 0;
+	for (std::size_t i = 0; i < m_alive.size(); i++) {
+		m_alive[i] = m_alive[i] != 0;
+		m_visible[i] = m_visible[i] != 0;
+		m_launched[i] = m_launched[i] != 0;
+		m_aliveCount += m_alive[i];
+		solveDeathTime(i);
+	}
+	rescheduleAll();
+	return true;
+}
+
+const std::vector<ParticleSystem::Index>& ParticleSystem::getBornParticles() const
+{
+	return m_bornParticles;
+}
+
+const std::vector<ParticleSystem::Index>& ParticleSystem::getDiedParticles() const
+{
+	return m_diedParticles;
+}
+
+void ParticleSystem::flagDying(std::size_t begin, std::size_t end)
+{
+	for (std::size_t i = begin; i < end; i++) {
+		m_dying[i] = m_visible[i] && m_deathCondition(*this, i);
+	}
+}
+
+void ParticleSystem::evaluateTrajectories(std::size_t begin, std::size_t end)
+{
+	for (std::size_t i = begin; i < end; i++) {
+		if (!m_visible[i]) {
+			continue;
+		}
+
+		//p = p0 + v0 t + a t^2 / 2, v = v0 + a t, from the launch state, at the time since birth
+		const State& state = m_resetState[i];
+		const float time = float(m_clock - m_launchTime[i]) - m_timeOfBirth[i];
+		m_velocityX[i] = state.velocity.x + state.acceleration.x * time;
+		m_velocityY[i] = state.velocity.y + state.acceleration.y * time;
+		m_positionX[i] = state.position.x + (state.velocity.x + 0.5f * state.acceleration.x * time) * time;
+		m_positionY[i] = state.position.y + (state.velocity.y + 0.5f * state.acceleration.y * time) * time;
+	}
+}
+
+void ParticleSystem::solveDeathTime(Index index)
+{
+	m_deathTime[index] = std::numeric_limits<float>::infinity();
+	if (!m_hasDeathBoundary) {
+		return;
+	}
+
+	//distance to the boundary along its normal: d(t) = c + b t + a t^2 / 2, the particle dies at the first t where d(t) < 0
+	const State& state = m_resetState[index];
+	const sf::Vector2f& normal = m_deathBoundaryNormal;
+	const double c = double(normal.x) * state.position.x + double(normal.y) * state.position.y - m_deathBoundaryOffset;
+	const double b = double(normal.x) * state.velocity.x + double(normal.y) * state.velocity.y;
+	const double a = double(normal.x) * state.acceleration.x + double(normal.y) * state.acceleration.y;
+
+	if (c < 0) {
+		m_deathTime[index] = 0;
+	}
+	else if (a == 0) {
+		if (b < 0) {
+			m_deathTime[index] = float(-c / b);
+		}
+	}
+	else {
+		const double discriminant = b * b - 2 * a * c;
+		if (discriminant > 0 || a < 0) {
+			//roots of a t^2 / 2 + b t + c, without cancellation: if the parabola opens upwards, the particle crosses at the smaller
+			//root (if it is ahead, it only touches it on a double root); if it opens downwards, at the larger one (never behind, as c >= 0)
+			const double q = -(b + std::copysign(std::sqrt(discriminant), b));
+			const double root1 = q / a;
+			const double root2 = q != 0 ? 2 * c / q : root1;
+			const double deathTime = a > 0 ? std::min(root1, root2) : std::max(root1, root2);
+			if (deathTime >= 0) {
+				m_deathTime[index] = float(deathTime);
+			}
+		}
+	}
+}
+
+bool ParticleSystem::isDeathPredicted() const
+{
+	return m_kinematics == Analytic && m_hasDeathBoundary;
+}
+
+void ParticleSystem::scheduleParticle(Index index)
+{
+	m_timers.cancel(m_birthTimer[index]);
+	m_timers.cancel(m_deathTimer[index]);
+	m_birthTimer[index] = 0;
+	m_deathTimer[index] = 0;
+	if (!m_alive[index]) {
+		return;
+	}
+
+	ParticleSystem* system = this;
+	const double birthTime = m_launchTime[index] + m_timeOfBirth[index];
+	if (!m_visible[index]) {
+		m_birthTimer[index] = m_timers.schedule(birthTime, Delegate<void()>::fromFunctor([system, index]() {
+			system->m_birthTimer[index] = 0;
+			system->m_visible[index] = 1;
+			system->m_bornParticles.push_back(index);
+		}));
+	}
+	if (isDeathPredicted() && m_deathTime[index] != std::numeric_limits<float>::infinity()) {
+		m_deathTimer[index] = m_timers.schedule(birthTime + m_deathTime[index], Delegate<void()>::fromFunctor([system, index]() {
+			system->m_deathTimer[index] = 0;
+			system->m_dueDeaths.push_back(index);
+		}));
+	}
+}
+
+void ParticleSystem::rescheduleAll()
+{
+	m_timers.reset(m_clock);
+	m_dueDeaths.clear();
+	for (Index i = 0; i < m_positionX.size(); i++) {
+		m_birthTimer[i] = 0;
+		m_deathTimer[i] = 0;
+		scheduleParticle(i);
+	}
+}
+
+void ParticleSystem::writeState(Index index, const State& state)
+{
+	m_positionX[index] = state.position.x;
+	m_positionY[index] = state.position.y;
+	m_previousPositionX[index] = state.position.x;
+	m_previousPositionY[index] = state.position.y;
+	m_velocityX[index] = state.velocity.x;
+	m_velocityY[index] = state.velocity.y;
+	m_accelerationX[index] = state.acceleration.x;
+	m_accelerationY[index] = state.acceleration.y;
+}
@@ -8,16 +8,17 @@
 
 #include "PolyParticleShape.hpp"
 #include "MathModule.hpp"
-#include "CustomSound.hpp"
+#include "SoundEffect.hpp"
+#include "ResourceManager.hpp"
 
 PolyParticleShape::PolyParticleShape(
+	boost::shared_ptr<ParticleSystem> system,
 	const sf::Vector2f& pos,
 	int nPoints,
 	float radius,
 	const sf::Color& backgroundColor) :
-	p_textureActive(false),
-	m_isVisible(false),
-	m_birthSoundPlayed(false)
+	ParticleInterface(system),
+	p_textureActive(false)
 {
 	//setup convex polygon shape:
 	p_convexShape.setPosition(pos);
@@ -28,12 +29,13 @@ PolyParticleShape::PolyParticleShape(
 }
 
 PolyParticleShape::PolyParticleShape(
+	boost::shared_ptr<ParticleSystem> system,
 	const sf::Vector2f& pos,
 	int nPoints,
 	float radius,
 	const std::string& path) :
-	p_textureActive(true),
-	m_isVisible(false)
+	ParticleInterface(system),
+	p_textureActive(true)
 {
 	//setup convex polygon shape:
 	p_convexShape.setPosition(pos);
@@ -53,16 +55,64 @@ void PolyParticleShape::randomizeColor() {
 
 void PolyParticleShape::setTexture(const std::string& path, bool activate)
 {
-	//allocate
-	p_texture.reset(new sf::Texture);
-	if (p_texture->loadFromFile(path)) {
+	//shared, decoded only once
+	setTexture(ResourceManager::getTexture(path), activate);
+}
 
-		if (activate) {
-			enableTexture(activate);
-		}
+boost::shared_ptr<sf::Texture> PolyParticleShape::getTexture() const
+{
+	if (p_textureActive) {
+		return p_texture;
+	}
+	return nullptr;
+}
+
+std::size_t PolyParticleShape::appendLocalTriangles(std::vector<sf::Vertex>& vertices) const
+{
+	std::size_t pointCount = p_convexShape.getPointCount();
+	if (pointCount < 3) {
+		return 0;
 	}
-	else {
-		throw("CAN'T LOAD TEXTURE: " + path);
+
+	//same local transform as the ConvexShape, without the translation:
+	sf::Transform transform;
+	transform.rotate(p_convexShape.getRotation());
+	transform.scale(p_convexShape.getScale());
+	transform.translate(-p_convexShape.getOrigin());
+
+	//texture coordinates are mapped over the local bounds, as ConvexShape does:
+	sf::FloatRect bounds = p_convexShape.getLocalBounds();
+	sf::IntRect textureRect = p_convexShape.getTextureRect();
+	sf::Color color = p_convexShape.getFillColor();
+
+	sf::Vector2f center;
+	for (std::size_t i = 0; i < pointCount; i++) {
+		center += p_convexShape.getPoint(i);
+	}
+	center = center / float(pointCount);
+
+	auto makeVertex = [&](const sf::Vector2f& point) {
+		float u = (bounds.width > 0) ? (point.x - bounds.left) / bounds.width : 0;
+		float v = (bounds.height > 0) ? (point.y - bounds.top) / bounds.height : 0;
+		return sf::Vertex(transform.transformPoint(point), color,
+			{ textureRect.left + u * textureRect.width, textureRect.top + v * textureRect.height });
+	};
+
+	//triangle fan around the center, written as a triangle list:
+	for (std::size_t i = 0; i < pointCount; i++) {
+		vertices.push_back(makeVertex(center));
+		vertices.push_back(makeVertex(p_convexShape.getPoint(i)));
+		vertices.push_back(makeVertex(p_convexShape.getPoint((i + 1) % pointCount)));
+	}
+
+	return 3 * pointCount;
+}
+
+void PolyParticleShape::setTexture(boost::shared_ptr<sf::Texture> texture, bool activate)
+{
+	p_texture = texture;
+	if (activate) {
+		enableTexture(activate);
 	}
 }
 
@@ -83,11 +133,12 @@ void PolyParticleShape::resetPositon(const sf::Vector2f& pos)
 	p_convexShape.setPosition(pos);
 }
 
-void PolyParticleShape::drawTo(sf::RenderWindow* window)
+void PolyParticleShape::drawTo(sf::RenderTarget* target)
 {
 	//only render if is alive
-	if (m_isVisible && window != nullptr) {
-		window->draw(p_convexShape);
+	if (isVisible() && target != nullptr) {
+		p_convexShape.setPosition(p_system->getInterpolatedPosition(p_index));
+		target->draw(p_convexShape);
 	}
 }
 
@@ -115,43 +166,6 @@ void PolyParticleShape::generatePolygon(int nPoints, float radius)
 	p_convexShape.setRotation(angle);
 }
 
-void PolyParticleShape::updatePhysics(float deltaTime) {
-
-	if (p_isAlive) {
-		p_timeAlive += deltaTime;
-
-		//euler integration
-		if (p_timeAlive >= p_timeOfBirth) {
-			m_isVisible = true;
-			p_state.velocity += deltaTime * p_state.acceleration;
-			p_state.position += deltaTime * p_state.velocity;
-
-			//birth sound, played when it is born:
-			if (!m_birthSoundPlayed && p_birthSound != nullptr && p_birthSoundActive) {
-				m_birthSoundPlayed = true;
-				p_birthSound->play();
-			}
-		}
-
-		if (p_deathCondition != nullptr && p_deathCondition(p_deathConditionArgsMap)) {
-			death();
-		}
-
-		p_convexShape.setPosition(p_state.position);
-	}
-}
-
-void PolyParticleShape::setBirthState(const State& state, float timeOfBirth)
-{
-	p_state = state;
-	p_timeOfBirth = timeOfBirth;
-	p_resetState = state;
-}
-
-void PolyParticleShape::setResetState(const State& state) {
-	p_resetState = state;
-}
-
 void PolyParticleShape::setRandomBirthStateParams(const sf::Vector2f& subWindowArea) {
 	m_birthParams.position = subWindowArea;
 }
@@ -159,32 +173,36 @@ void PolyParticleShape::setRandomBirthStateParams(const sf::Vector2f& subWindowA
 void PolyParticleShape::setupRandomBirthState()
 {
 	State state;
-	state.position = { 0, MathModule::getRandom(0.25f * m_birthParams.position.y , 0.8f * m_birthParams.position.y) };//x axis
-	state.velocity = { MathModule::getRandom(250,300), 0 };//y axis
-	state.acceleration = { -MathModule::getRandom(80,150), 0 }; //y axis
-	p_state = state;
-	p_timeOfBirth = MathModule::getRandom(0, 2);
-
-	p_resetState = state;
-}
+	float timeOfBirth;
+	generateRandomBirthStates(m_birthParams.position, 1, &state, &timeOfBirth);
 
-void PolyParticleShape::resetToBirthState() {
-	p_state = p_resetState;
+	setBirthState(state, timeOfBirth);
 }
 
-void PolyParticleShape::birth()
+void PolyParticleShape::setupRandomBirthStates(const std::vector<boost::shared_ptr<PolyParticleShape>>& particles, const sf::Vector2f& subWindowArea)
 {
-	p_timeAlive = 0;//reset lifetime
-	m_birthSoundPlayed = false;
-	p_isAlive = true;//last thing
-}
+	std::vector<State> states(particles.size());
+	std::vector<float> timesOfBirth(particles.size());
+	generateRandomBirthStates(subWindowArea, particles.size(), states.data(), timesOfBirth.data());
 
-void PolyParticleShape::death() {
-	p_isAlive = false;//first thing
-	m_isVisible = false;
+	for (std::size_t i = 0; i < particles.size(); i++) {
+		particles[i]->m_birthParams.position = subWindowArea;
+		particles[i]->setBirthState(states[i], timesOfBirth[i]);
+	}
+}
 
-	//death sound:
-	if (p_deathSound != nullptr && p_deathSoundActive) {
-		p_deathSound->play();
+void PolyParticleShape::generateRandomBirthStates(const sf::Vector2f& subWindowArea, std::size_t count, State* states, float* timesOfBirth)
+{
+	//one bulk draw per state variable:
+	std::vector<float> positionY(count), velocityX(count), accelerationX(count);
+	MathModule::fillRandom(positionY.data(), count, 0.25f * subWindowArea.y, 0.8f * subWindowArea.y);
+	MathModule::fillRandom(velocityX.data(), count, 250, 300);
+	MathModule::fillRandom(accelerationX.data(), count, 80, 150);
+	MathModule::fillRandom(timesOfBirth, count, 0, 2);
+
+	for (std::size_t i = 0; i < count; i++) {
+		states[i].position = { 0, positionY[i] };//x axis
+		states[i].velocity = { velocityX[i], 0 };//y axis
+		states[i].acceleration = { -accelerationX[i], 0 }; //y axis
 	}
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+/*****************************************************************
+ * \file	Profiler.cpp
+ * \brief	Functions and methods for class Profiler, to be used with Profiler.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace {
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	void writeEscaped(std::ostream& stream, const char* text)
+	{
+		for (; *text != '\0'; text++) {
+			if (*text == '"' || *text == '\\') {
+				stream << '\\';
+			}
+			stream << *text;
+		}
+	}
+
+	void writeMicroseconds(std::ostream& stream, std::int64_t nanoseconds)
+	{
+		//the unit of the trace format, with a tenth of a microsecond, without losing digits on long captures:
+		stream << nanoseconds / 1000 << '.' << (nanoseconds % 1000) / 100;
+	}
+}
+
+std::atomic<bool> Profiler::s_enabled(false);
+
+Profiler::ThreadBuffer::ThreadBuffer(std::size_t id) :
+	head(0),
+	first(0),
+	threadId(id)
+{
+}
+
+Profiler::Profiler()
+{
+}
+
+Profiler& Profiler::getInstance()
+{
+	static Profiler instance;
+	return instance;
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+	s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(getInstance().m_mutex);
+	buffer.threadName = name;
+}
+
+std::int64_t Profiler::getTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Profiler::record(const char* name, std::int64_t begin, std::int64_t end)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	if (buffer.events == nullptr) {
+		buffer.events.reset(new Event[ringCapacity]());
+	}
+
+	//single writer, the slot is filled before the head moves past it:
+	std::uint64_t sequence = buffer.head.load(std::memory_order_relaxed);
+	Event& event = buffer.events[sequence & (ringCapacity - 1)];
+	event.name.store(name, std::memory_order_relaxed);
+	event.begin.store(begin, std::memory_order_relaxed);
+	event.end.store(end, std::memory_order_relaxed);
+	buffer.head.store(sequence + 1, std::memory_order_release);
+}
+
+void Profiler::clear()
+{
+	Profiler& instance = getInstance();
+	std::lock_guard<std::mutex> lock(instance.m_mutex);
+	for (const boost::shared_ptr<ThreadBuffer>& buffer : instance.m_threadBuffers) {
+		buffer->first.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
+
+std::size_t Profiler::writeChromeTrace(std::ostream& stream)
+{
+	Profiler& instance = getInstance();
+	std::lock_guard<std::mutex> lock(instance.m_mutex);
+
+	std::size_t zoneCount = 0;
+	bool firstEntry = true;
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	for (const boost::shared_ptr<ThreadBuffer>& buffer : instance.m_threadBuffers) {
+		if (!buffer->threadName.empty()) {
+			stream << (firstEntry ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+				<< ",\"args\":{\"name\":\"";
+			writeEscaped(stream, buffer->threadName.c_str());
+			stream << "\"}}";
+			firstEntry = false;
+		}
+
+		//copy the zones still on the ring, then drop the ones the thread overwrote meanwhile:
+		std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+		std::uint64_t first = std::max(buffer->first.load(std::memory_order_relaxed), head > ringCapacity ? head - ringCapacity : 0);
+		std::vector<std::pair<const char*, std::pair<std::int64_t, std::int64_t>>> zones;
+		zones.reserve(std::size_t(head - first));
+		for (std::uint64_t sequence = first; sequence < head; sequence++) {
+			const Event& event = buffer->events[sequence & (ringCapacity - 1)];
+			zones.push_back({ event.name.load(std::memory_order_relaxed),
+				{ event.begin.load(std::memory_order_relaxed), event.end.load(std::memory_order_relaxed) } });
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		std::uint64_t newHead = buffer->head.load(std::memory_order_relaxed);
+		std::uint64_t valid = newHead + 1 > ringCapacity ? newHead + 1 - ringCapacity : 0;
+		std::size_t skipped = valid > first ? std::size_t(std::min(valid - first, head - first)) : 0;
+
+		for (std::size_t i = skipped; i < zones.size(); i++) {
+			stream << (firstEntry ? "\n" : ",\n") << "{\"name\":\"";
+			writeEscaped(stream, zones[i].first);
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+			writeMicroseconds(stream, zones[i].second.first);
+			stream << ",\"dur\":";
+			writeMicroseconds(stream, zones[i].second.second - zones[i].second.first);
+			stream << "}";
+			firstEntry = false;
+			zoneCount++;
+		}
+	}
+
+	stream << "\n]}\n";
+	return zoneCount;
+}
+
+std::size_t Profiler::saveChromeTrace(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file) {
+		throw("CAN'T SAVE PROFILER TRACE");
+	}
+	return writeChromeTrace(file);
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+	static thread_local ThreadBuffer* threadBuffer = nullptr;
+
+	if (threadBuffer == nullptr) {
+		Profiler& instance = getInstance();
+		std::lock_guard<std::mutex> lock(instance.m_mutex);
+		instance.m_threadBuffers.push_back(boost::shared_ptr<ThreadBuffer>(new ThreadBuffer(instance.m_threadBuffers.size() + 1)));
+		threadBuffer = instance.m_threadBuffers.back().get();
+	}
+	return *threadBuffer;
+}
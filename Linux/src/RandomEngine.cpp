@@ -0,0 +1,189 @@
+/*****************************************************************
+ * \file	RandomEngine.cpp
+ * \brief	Functions and methods for class RandomEngine, to be used with RandomEngine.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "RandomEngine.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace {
+	inline std::uint64_t rotateLeft(std::uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	inline std::uint64_t splitMix64(std::uint64_t& state)
+	{
+		std::uint64_t value = (state += 0x9e3779b97f4a7c15ULL);
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	}
+
+	inline float toUnitFloat(std::uint64_t value)
+	{
+		//the 24 high bits, the precision of a float mantissa:
+		return float(value >> 40) * (1.0f / 16777216.0f);
+	}
+
+	std::uint64_t timeSeed()
+	{
+		return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+	}
+
+	std::atomic<std::uint64_t> globalSeed(timeSeed());
+	std::atomic<unsigned int> globalSeedGeneration(0);
+	std::atomic<unsigned int> threadStreamCount(0);
+}
+
+RandomEngine::RandomEngine(std::uint64_t seed)
+{
+	this->seed(seed);
+}
+
+RandomEngine::RandomEngine(std::uint64_t seed, unsigned int stream)
+{
+	this->seed(seed);
+	for (unsigned int i = 0; i < stream; i++) {
+		jump();
+	}
+}
+
+void RandomEngine::seed(std::uint64_t seed)
+{
+	//expand the seed, the state can't be all zeros:
+	std::uint64_t splitMixState = seed;
+	for (std::uint64_t& word : m_state) {
+		word = splitMix64(splitMixState);
+	}
+}
+
+RandomEngine::result_type RandomEngine::operator()()
+{
+	const std::uint64_t result = rotateLeft(m_state[1] * 5, 7) * 9;
+	const std::uint64_t shifted = m_state[1] << 17;
+
+	m_state[2] ^= m_state[0];
+	m_state[3] ^= m_state[1];
+	m_state[1] ^= m_state[2];
+	m_state[0] ^= m_state[3];
+	m_state[2] ^= shifted;
+	m_state[3] = rotateLeft(m_state[3], 45);
+
+	return result;
+}
+
+float RandomEngine::nextFloat()
+{
+	return toUnitFloat((*this)());
+}
+
+float RandomEngine::uniform(float lowest, float highest)
+{
+	return lowest + nextFloat() * (highest - lowest);
+}
+
+void RandomEngine::fillUniform(float* values, std::size_t count, float lowest, float highest)
+{
+	//state kept in registers for the whole fill:
+	std::uint64_t s0 = m_state[0], s1 = m_state[1], s2 = m_state[2], s3 = m_state[3];
+	const float range = highest - lowest;
+
+	for (std::size_t i = 0; i < count; i++) {
+		const std::uint64_t result = rotateLeft(s1 * 5, 7) * 9;
+		const std::uint64_t shifted = s1 << 17;
+		s2 ^= s0;
+		s3 ^= s1;
+		s1 ^= s2;
+		s0 ^= s3;
+		s2 ^= shifted;
+		s3 = rotateLeft(s3, 45);
+
+		values[i] = lowest + toUnitFloat(result) * range;
+	}
+
+	m_state[0] = s0;
+	m_state[1] = s1;
+	m_state[2] = s2;
+	m_state[3] = s3;
+}
+
+void RandomEngine::jump()
+{
+	static const std::uint64_t polynomial[4] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+	applyJump(polynomial);
+}
+
+void RandomEngine::longJump()
+{
+	static const std::uint64_t polynomial[4] = {
+		0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+	applyJump(polynomial);
+}
+
+void RandomEngine::getState(std::uint64_t(&state)[4]) const
+{
+	for (int i = 0; i < 4; i++) {
+		state[i] = m_state[i];
+	}
+}
+
+void RandomEngine::setState(const std::uint64_t(&state)[4])
+{
+	for (int i = 0; i < 4; i++) {
+		m_state[i] = state[i];
+	}
+}
+
+void RandomEngine::setGlobalSeed(std::uint64_t seed)
+{
+	globalSeed.store(seed);
+	globalSeedGeneration.fetch_add(1);
+}
+
+std::uint64_t RandomEngine::getGlobalSeed()
+{
+	return globalSeed.load();
+}
+
+RandomEngine& RandomEngine::getThreadEngine()
+{
+	static thread_local unsigned int threadStream = threadStreamCount.fetch_add(1);
+	static thread_local unsigned int seedGeneration = ~0u;
+	static thread_local RandomEngine engine;
+
+	//(re)seed on first use, or when the global seed changed:
+	unsigned int currentGeneration = globalSeedGeneration.load();
+	if (seedGeneration != currentGeneration) {
+		seedGeneration = currentGeneration;
+		engine.seed(globalSeed.load());
+		for (unsigned int i = 0; i <= threadStream; i++) {
+			engine.longJump();
+		}
+	}
+	return engine;
+}
+
+void RandomEngine::applyJump(const std::uint64_t(&polynomial)[4])
+{
+	std::uint64_t jumped[4] = { 0, 0, 0, 0 };
+	for (std::uint64_t word : polynomial) {
+		for (int bit = 0; bit < 64; bit++) {
+			if (word & (std::uint64_t(1) << bit)) {
+				for (int i = 0; i < 4; i++) {
+					jumped[i] ^= m_state[i];
+				}
+			}
+			(*this)();
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		m_state[i] = jumped[i];
+	}
+}
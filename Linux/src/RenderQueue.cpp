@@ -0,0 +1,114 @@
+/*****************************************************************
+ * \file	RenderQueue.cpp
+ * \brief	Functions and methods for class RenderQueue, to be used with RenderQueue.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "RenderQueue.hpp"
+
+#include <functional>
+
+RenderQueue::RenderQueue() :
+	m_nextSequence(0),
+	m_lastTarget(nullptr),
+	m_lastTexture(nullptr)
+{}
+
+void RenderQueue::add(boost::shared_ptr<WindowInterface> child, int layer)
+{
+	if (child == nullptr) {
+		return;
+	}
+	for (std::size_t pass = 0; pass < child->getDrawPassCount(); pass++) {
+		Draw draw;
+		draw.child = child;
+		draw.layer = layer;
+		draw.pass = pass;
+		draw.texture = child->getDrawPassTexture(pass);
+		draw.sequence = m_nextSequence++;
+		m_draws.push_back(draw);
+	}
+}
+
+void RenderQueue::beginFrame()
+{
+	for (Draw& draw : m_draws) {
+		draw.texture = draw.child->getDrawPassTexture(draw.pass);
+	}
+
+	//insertion sort, linear while the order of the last frame holds, only the draws whose texture changed move:
+	for (std::size_t i = 1; i < m_draws.size(); i++) {
+		if (!isBefore(m_draws[i], m_draws[i - 1])) {
+			continue;
+		}
+		Draw draw = m_draws[i];
+		std::size_t j = i;
+		do {
+			m_draws[j] = m_draws[j - 1];
+			j--;
+		} while (j > 0 && isBefore(draw, m_draws[j - 1]));
+		m_draws[j] = draw;
+	}
+
+	m_lastTarget = nullptr;
+	m_lastTexture = nullptr;
+	m_frameStats = Stats();
+	m_frameStats.frames = 1;
+	m_totalStats.frames++;
+}
+
+void RenderQueue::draw(sf::RenderTarget* target, int firstLayer, int lastLayer)
+{
+	if (target == nullptr) {
+		return;
+	}
+	for (Draw& draw : m_draws) {
+		if (draw.layer < firstLayer) {
+			continue;
+		}
+		if (draw.layer > lastLayer) {
+			break;
+		}
+		draw.child->drawPassTo(target, draw.pass);
+		recordDraw(target, draw.texture);
+	}
+}
+
+void RenderQueue::recordDraw(sf::RenderTarget* target, const sf::Texture* texture)
+{
+	//each target binds its own textures:
+	if (target != m_lastTarget || texture != m_lastTexture) {
+		m_frameStats.binds++;
+		m_totalStats.binds++;
+	}
+	m_frameStats.draws++;
+	m_totalStats.draws++;
+	m_lastTarget = target;
+	m_lastTexture = texture;
+}
+
+const RenderQueue::Stats& RenderQueue::getFrameStats() const
+{
+	return m_frameStats;
+}
+
+const RenderQueue::Stats& RenderQueue::getTotalStats() const
+{
+	return m_totalStats;
+}
+
+bool RenderQueue::isBefore(const Draw& a, const Draw& b)
+{
+	if (a.layer != b.layer) {
+		return a.layer < b.layer;
+	}
+	if (a.pass != b.pass) {
+		return a.pass < b.pass;
+	}
+	if (a.texture != b.texture) {
+		return std::less<const sf::Texture*>()(a.texture, b.texture);
+	}
+	return a.sequence < b.sequence;
+}
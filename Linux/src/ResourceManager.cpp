@@ -0,0 +1,140 @@
+/*****************************************************************
+ * \file	ResourceManager.cpp
+ * \brief	Functions and methods for class ResourceManager, to be used with ResourceManager.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "ResourceManager.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+ResourceManager::ResourceManager()
+{
+}
+
+ResourceManager& ResourceManager::getInstance()
+{
+	static ResourceManager instance;
+	return instance;
+}
+
+boost::shared_ptr<sf::Texture> ResourceManager::getTexture(const std::string& path)
+{
+	ResourceManager& instance = getInstance();
+
+	boost::shared_ptr<sf::Texture> texture = instance.m_textureMap[path].lock();
+	if (texture != nullptr) {
+		instance.m_textureStats.hits++;
+		return texture;
+	}
+
+	//decode and upload, only once while the texture is referenced:
+	texture.reset(new sf::Texture);
+	if (!texture->loadFromFile(path)) {
+		throw("CAN'T LOAD TEXTURE: " + path);
+	}
+	instance.m_textureStats.misses++;
+	instance.m_textureMap[path] = texture;
+
+	return texture;
+}
+
+ResourceManager::Stats ResourceManager::getTextureStats()
+{
+	ResourceManager& instance = getInstance();
+
+	Stats stats = instance.m_textureStats;
+	for (const std::pair<const std::string, boost::weak_ptr<sf::Texture>>& texturePair : instance.m_textureMap) {
+		boost::shared_ptr<sf::Texture> texture = texturePair.second.lock();
+		if (texture != nullptr) {
+			stats.resident++;
+			stats.bytesResident += std::size_t(texture->getSize().x) * texture->getSize().y * 4; //RGBA
+		}
+	}
+	return stats;
+}
+
+boost::shared_ptr<sf::SoundBuffer> ResourceManager::getSoundBuffer(const std::string& path)
+{
+	ResourceManager& instance = getInstance();
+
+	boost::shared_ptr<sf::SoundBuffer> soundBuffer = instance.m_soundBufferMap[path].lock();
+	if (soundBuffer != nullptr) {
+		instance.m_soundBufferStats.hits++;
+		return soundBuffer;
+	}
+
+	//decode, only once while the buffer is referenced:
+	soundBuffer.reset(new sf::SoundBuffer);
+	if (!soundBuffer->loadFromFile(path)) {
+		throw("CAN'T LOAD SOUND: " + path);
+	}
+	instance.m_soundBufferStats.misses++;
+	instance.m_soundBufferMap[path] = soundBuffer;
+
+	return soundBuffer;
+}
+
+ResourceManager::Stats ResourceManager::getSoundBufferStats()
+{
+	ResourceManager& instance = getInstance();
+
+	Stats stats = instance.m_soundBufferStats;
+	for (const std::pair<const std::string, boost::weak_ptr<sf::SoundBuffer>>& soundBufferPair : instance.m_soundBufferMap) {
+		boost::shared_ptr<sf::SoundBuffer> soundBuffer = soundBufferPair.second.lock();
+		if (soundBuffer != nullptr) {
+			stats.resident++;
+			stats.bytesResident += std::size_t(soundBuffer->getSampleCount()) * sizeof(sf::Int16);
+		}
+	}
+	return stats;
+}
+
+boost::shared_ptr<sf::Font> ResourceManager::getFont(const std::string& path, unsigned int characterSize)
+{
+	ResourceManager& instance = getInstance();
+	FontEntry& entry = instance.m_fontMap[path];
+
+	boost::shared_ptr<sf::Font> font = entry.font.lock();
+	if (font != nullptr) {
+		instance.m_fontStats.hits++;
+	}
+	else {
+		//parse, only once while the font is referenced:
+		font.reset(new sf::Font);
+		if (!font->loadFromFile(path)) {
+			throw("CAN'T LOAD FONT: " + path);
+		}
+		instance.m_fontStats.misses++;
+		entry.font = font;
+		entry.characterSizes.clear();
+	}
+
+	if (characterSize > 0) {
+		entry.characterSizes.insert(characterSize);
+	}
+
+	return font;
+}
+
+ResourceManager::Stats ResourceManager::getFontStats()
+{
+	ResourceManager& instance = getInstance();
+
+	Stats stats = instance.m_fontStats;
+	for (const std::pair<const std::string, FontEntry>& fontPair : instance.m_fontMap) {
+		boost::shared_ptr<sf::Font> font = fontPair.second.font.lock();
+		if (font != nullptr) {
+			stats.resident++;
+			for (unsigned int characterSize : fontPair.second.characterSizes) {
+				const sf::Texture& page = font->getTexture(characterSize);
+				stats.glyphPages++;
+				stats.bytesResident += std::size_t(page.getSize().x) * page.getSize().y * 4; //RGBA
+			}
+		}
+	}
+	return stats;
+}
@@ -0,0 +1,318 @@
+/*****************************************************************
+ * \file	SessionRecording.cpp
+ * \brief	Functions and methods for class SessionRecording, to be used with SessionRecording.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "SessionRecording.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+	const std::uint32_t recordingMagic = 0x52534341;//"ACSR"
+	const std::uint32_t recordingVersion = 1;
+
+	//record tags:
+	enum Tag : std::uint8_t {
+		FrameTag = 1,
+		EventTag,
+		EndTag
+	};
+
+	std::int16_t toCoordinate(int value)
+	{
+		return std::int16_t(std::max(-32768, std::min(32767, value)));
+	}
+}
+
+bool SessionRecording::Result::operator==(const Result& other) const
+{
+	return frames == other.frames && playCount == other.playCount && insertCount == other.insertCount &&
+		removeCount == other.removeCount && checksum == other.checksum;
+}
+
+SessionRecording::SessionRecording(const std::string& path, const Header& header) :
+	m_replaying(false),
+	m_header(header),
+	m_file(path, std::ios::binary | std::ios::trunc),
+	m_position(0),
+	m_frames(0),
+	m_ended(false)
+{
+	if (!m_file) {
+		throw("CAN'T SAVE SESSION RECORDING");
+	}
+	write(&recordingMagic, sizeof(recordingMagic));
+	write(&recordingVersion, sizeof(recordingVersion));
+	write(&m_header.seed, sizeof(m_header.seed));
+	write(&m_header.stepTime, sizeof(m_header.stepTime));
+	write(&m_header.kinematics, sizeof(m_header.kinematics));
+	write(&m_header.playCount, sizeof(m_header.playCount));
+	write(&m_header.insertCount, sizeof(m_header.insertCount));
+	write(&m_header.removeCount, sizeof(m_header.removeCount));
+}
+
+SessionRecording::SessionRecording(const std::string& path) :
+	m_replaying(true),
+	m_position(0),
+	m_frames(0),
+	m_ended(false)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw("CAN'T LOAD SESSION RECORDING");
+	}
+	m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) || magic != recordingMagic || version != recordingVersion ||
+		!read(&m_header.seed, sizeof(m_header.seed)) || !read(&m_header.stepTime, sizeof(m_header.stepTime)) ||
+		!read(&m_header.kinematics, sizeof(m_header.kinematics)) || !read(&m_header.playCount, sizeof(m_header.playCount)) ||
+		!read(&m_header.insertCount, sizeof(m_header.insertCount)) || !read(&m_header.removeCount, sizeof(m_header.removeCount))) {
+		throw("CAN'T LOAD SESSION RECORDING");
+	}
+}
+
+SessionRecording::~SessionRecording()
+{
+}
+
+bool SessionRecording::isReplaying() const
+{
+	return m_replaying;
+}
+
+const SessionRecording::Header& SessionRecording::getHeader() const
+{
+	return m_header;
+}
+
+void SessionRecording::recordFrame(float frameTime)
+{
+	const std::uint8_t tag = FrameTag;
+	write(&tag, sizeof(tag));
+	write(&frameTime, sizeof(frameTime));
+	m_frames++;
+}
+
+void SessionRecording::recordEvent(const sf::Event& evnt)
+{
+	//the payload of each event type, the others aren't recorded:
+	unsigned char payload[16];
+	std::size_t size = 0;
+	switch (evnt.type) {
+	case sf::Event::Closed:
+	case sf::Event::LostFocus:
+	case sf::Event::GainedFocus:
+	case sf::Event::MouseEntered:
+	case sf::Event::MouseLeft:
+		break;
+
+	case sf::Event::Resized: {
+		const std::uint32_t values[2] = { evnt.size.width, evnt.size.height };
+		std::memcpy(payload, values, sizeof(values));
+		size = sizeof(values);
+		break;
+	}
+
+	case sf::Event::KeyPressed:
+	case sf::Event::KeyReleased: {
+		const std::int32_t code = evnt.key.code;
+		const std::uint8_t modifiers = std::uint8_t((evnt.key.alt ? 1 : 0) | (evnt.key.control ? 2 : 0) |
+			(evnt.key.shift ? 4 : 0) | (evnt.key.system ? 8 : 0));
+		std::memcpy(payload, &code, sizeof(code));
+		std::memcpy(payload + sizeof(code), &modifiers, sizeof(modifiers));
+		size = sizeof(code) + sizeof(modifiers);
+		break;
+	}
+
+	case sf::Event::MouseMoved: {
+		const std::int16_t values[2] = { toCoordinate(evnt.mouseMove.x), toCoordinate(evnt.mouseMove.y) };
+		std::memcpy(payload, values, sizeof(values));
+		size = sizeof(values);
+		break;
+	}
+
+	case sf::Event::MouseButtonPressed:
+	case sf::Event::MouseButtonReleased: {
+		const std::uint8_t button = std::uint8_t(evnt.mouseButton.button);
+		const std::int16_t values[2] = { toCoordinate(evnt.mouseButton.x), toCoordinate(evnt.mouseButton.y) };
+		payload[0] = button;
+		std::memcpy(payload + 1, values, sizeof(values));
+		size = 1 + sizeof(values);
+		break;
+	}
+
+	case sf::Event::MouseWheelScrolled: {
+		const std::uint8_t wheel = std::uint8_t(evnt.mouseWheelScroll.wheel);
+		const std::int16_t values[2] = { toCoordinate(evnt.mouseWheelScroll.x), toCoordinate(evnt.mouseWheelScroll.y) };
+		payload[0] = wheel;
+		std::memcpy(payload + 1, &evnt.mouseWheelScroll.delta, sizeof(float));
+		std::memcpy(payload + 1 + sizeof(float), values, sizeof(values));
+		size = 1 + sizeof(float) + sizeof(values);
+		break;
+	}
+
+	default:
+		return;
+	}
+
+	const std::uint8_t header[2] = { EventTag, std::uint8_t(evnt.type) };
+	write(header, sizeof(header));
+	write(payload, size);
+}
+
+void SessionRecording::recordEnd(const Result& result)
+{
+	if (m_ended) {
+		return;
+	}
+	const std::uint8_t tag = EndTag;
+	write(&tag, sizeof(tag));
+	write(&m_frames, sizeof(m_frames));
+	write(&result.playCount, sizeof(result.playCount));
+	write(&result.insertCount, sizeof(result.insertCount));
+	write(&result.removeCount, sizeof(result.removeCount));
+	write(&result.checksum, sizeof(result.checksum));
+	m_file.close();
+	m_ended = true;
+}
+
+bool SessionRecording::replayFrame(float& frameTime, std::vector<sf::Event>& events)
+{
+	events.clear();
+	std::uint8_t tag = 0;
+	if (m_ended || !read(&tag, sizeof(tag))) {
+		return false;
+	}
+
+	if (tag == EndTag) {
+		Result result;
+		if (read(&result.frames, sizeof(result.frames)) && read(&result.playCount, sizeof(result.playCount)) &&
+			read(&result.insertCount, sizeof(result.insertCount)) && read(&result.removeCount, sizeof(result.removeCount)) &&
+			read(&result.checksum, sizeof(result.checksum))) {
+			m_result = result;
+			m_ended = true;
+		}
+		return false;
+	}
+	if (tag != FrameTag || !read(&frameTime, sizeof(frameTime))) {
+		return false;
+	}
+
+	//the events, up to the next frame:
+	while (m_position < m_data.size() && m_data[m_position] == EventTag) {
+		std::uint8_t type = 0;
+		m_position++;
+		if (!read(&type, sizeof(type))) {
+			return false;
+		}
+
+		sf::Event evnt;
+		std::memset(&evnt, 0, sizeof(evnt));
+		evnt.type = sf::Event::EventType(type);
+		bool valid = true;
+		switch (evnt.type) {
+		case sf::Event::Closed:
+		case sf::Event::LostFocus:
+		case sf::Event::GainedFocus:
+		case sf::Event::MouseEntered:
+		case sf::Event::MouseLeft:
+			break;
+
+		case sf::Event::Resized: {
+			std::uint32_t values[2];
+			valid = read(values, sizeof(values));
+			evnt.size.width = values[0];
+			evnt.size.height = values[1];
+			break;
+		}
+
+		case sf::Event::KeyPressed:
+		case sf::Event::KeyReleased: {
+			std::int32_t code = 0;
+			std::uint8_t modifiers = 0;
+			valid = read(&code, sizeof(code)) && read(&modifiers, sizeof(modifiers));
+			evnt.key.code = sf::Keyboard::Key(code);
+			evnt.key.alt = (modifiers & 1) != 0;
+			evnt.key.control = (modifiers & 2) != 0;
+			evnt.key.shift = (modifiers & 4) != 0;
+			evnt.key.system = (modifiers & 8) != 0;
+			break;
+		}
+
+		case sf::Event::MouseMoved: {
+			std::int16_t values[2] = { 0, 0 };
+			valid = read(values, sizeof(values));
+			evnt.mouseMove.x = values[0];
+			evnt.mouseMove.y = values[1];
+			break;
+		}
+
+		case sf::Event::MouseButtonPressed:
+		case sf::Event::MouseButtonReleased: {
+			std::uint8_t button = 0;
+			std::int16_t values[2] = { 0, 0 };
+			valid = read(&button, sizeof(button)) && read(values, sizeof(values));
+			evnt.mouseButton.button = sf::Mouse::Button(button);
+			evnt.mouseButton.x = values[0];
+			evnt.mouseButton.y = values[1];
+			break;
+		}
+
+		case sf::Event::MouseWheelScrolled: {
+			std::uint8_t wheel = 0;
+			float delta = 0;
+			std::int16_t values[2] = { 0, 0 };
+			valid = read(&wheel, sizeof(wheel)) && read(&delta, sizeof(delta)) && read(values, sizeof(values));
+			evnt.mouseWheelScroll.wheel = sf::Mouse::Wheel(wheel);
+			evnt.mouseWheelScroll.delta = delta;
+			evnt.mouseWheelScroll.x = values[0];
+			evnt.mouseWheelScroll.y = values[1];
+			break;
+		}
+
+		default:
+			valid = false;
+			break;
+		}
+
+		//a truncated or unknown record ends the replay, after this frame:
+		if (!valid) {
+			m_position = m_data.size();
+			break;
+		}
+		events.push_back(evnt);
+	}
+
+	m_frames++;
+	return true;
+}
+
+bool SessionRecording::getRecordedResult(Result& result) const
+{
+	if (m_replaying && m_ended) {
+		result = m_result;
+	}
+	return m_replaying && m_ended;
+}
+
+void SessionRecording::write(const void* data, std::size_t size)
+{
+	m_file.write(static_cast<const char*>(data), std::streamsize(size));
+}
+
+bool SessionRecording::read(void* data, std::size_t size)
+{
+	if (m_data.size() - m_position < size) {
+		return false;
+	}
+	std::memcpy(data, m_data.data() + m_position, size);
+	m_position += size;
+	return true;
+}
@@ -0,0 +1,231 @@
+/*****************************************************************
+ * \file	SnapshotFile.cpp
+ * \brief	Functions and methods for class SnapshotFile, to be used with SnapshotFile.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "SnapshotFile.hpp"
+#include "MathModule.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	const std::uint32_t slotMagic = 0x31534753; //"SGS1"
+}
+
+double SnapshotFile::Stats::getAverageWriteTime() const
+{
+	//each snapshot written either reached a slot, or was replaced while pending:
+	return written + coalesced > 0 ? writeTime / (written + coalesced) : 0;
+}
+
+SnapshotFile::SnapshotFile(const std::string& path, std::size_t capacity) :
+	m_capacity(capacity),
+	m_slotSize(0),
+	m_file(-1),
+	m_mapping(nullptr),
+	m_recovered(false),
+	m_generation(0),
+	m_lastSlot(-1),
+	m_writingSlot(-1),
+	m_syncing{ false, false },
+	m_pendingSnapshot(capacity),
+	m_pendingSize(0),
+	m_hasPending(false),
+	m_stopping(false)
+{
+	//slots on their own pages, so that syncing one never touches the other:
+	std::size_t pageSize = std::size_t(::sysconf(_SC_PAGESIZE));
+	m_slotSize = (sizeof(SlotHeader) + capacity + pageSize - 1) / pageSize * pageSize;
+
+	m_file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	struct stat fileStatus;
+	if (m_file < 0 || ::fstat(m_file, &fileStatus) != 0) {
+		throw("CAN'T LOAD SNAPSHOT FILE");
+	}
+
+	//preallocated, so that writing to the mapping never runs out of disk:
+	if (std::size_t(fileStatus.st_size) != 2 * m_slotSize) {
+		if (::ftruncate(m_file, 0) != 0 || ::ftruncate(m_file, off_t(2 * m_slotSize)) != 0 ||
+			::posix_fallocate(m_file, 0, off_t(2 * m_slotSize)) != 0) {
+			throw("CAN'T LOAD SNAPSHOT FILE");
+		}
+	}
+
+	void* mapping = ::mmap(nullptr, 2 * m_slotSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+	if (mapping == MAP_FAILED) {
+		throw("CAN'T LOAD SNAPSHOT FILE");
+	}
+	m_mapping = static_cast<unsigned char*>(mapping);
+
+	//the latest whole snapshot:
+	for (int slot = 0; slot < 2; slot++) {
+		if (isSlotValid(slot) && getSlotHeader(slot)->generation > m_generation) {
+			m_generation = getSlotHeader(slot)->generation;
+			m_lastSlot = slot;
+		}
+	}
+	if (m_lastSlot >= 0) {
+		const unsigned char* data = reinterpret_cast<const unsigned char*>(getSlotHeader(m_lastSlot) + 1);
+		m_recoveredSnapshot.assign(data, data + getSlotHeader(m_lastSlot)->size);
+		m_recovered = true;
+	}
+
+	m_syncThread = std::thread(&SnapshotFile::syncLoop, this);
+}
+
+SnapshotFile::~SnapshotFile()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_syncCondition.notify_all();
+	if (m_syncThread.joinable()) {
+		m_syncThread.join();
+	}
+	::munmap(m_mapping, 2 * m_slotSize);
+	::close(m_file);
+}
+
+bool SnapshotFile::getRecoveredSnapshot(std::vector<unsigned char>& data) const
+{
+	if (m_recovered) {
+		data = m_recoveredSnapshot;
+	}
+	return m_recovered;
+}
+
+unsigned char* SnapshotFile::beginWrite()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_writeStart = std::chrono::steady_clock::now();
+
+	//the previous snapshot must be on disk before the other slot is torn by writing it, pending meanwhile:
+	if (m_syncing[0] || m_syncing[1]) {
+		if (m_hasPending) {
+			m_stats.coalesced++;
+			m_hasPending = false;
+		}
+		m_writingSlot = 2;
+		return m_pendingSnapshot.data();
+	}
+
+	//newer than a pending snapshot the sync thread didn't get to yet:
+	if (m_hasPending) {
+		m_stats.coalesced++;
+		m_hasPending = false;
+	}
+	m_writingSlot = m_lastSlot == 0 ? 1 : 0;
+	return reinterpret_cast<unsigned char*>(getSlotHeader(m_writingSlot) + 1);
+}
+
+void SnapshotFile::endWrite(std::size_t size)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_writingSlot < 0) {
+			return;
+		}
+
+		if (m_writingSlot == 2) {
+			m_pendingSize = size < m_capacity ? size : m_capacity;
+			m_hasPending = true;
+		}
+		else {
+			publishSlot(m_writingSlot, size);
+		}
+		m_writingSlot = -1;
+
+		double writeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_writeStart).count();
+		m_stats.writeTime += writeTime;
+		if (writeTime > m_stats.maxWriteTime) {
+			m_stats.maxWriteTime = writeTime;
+		}
+	}
+	m_syncCondition.notify_all();
+}
+
+SnapshotFile::Stats SnapshotFile::getStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+SnapshotFile::SlotHeader* SnapshotFile::getSlotHeader(int slot) const
+{
+	return reinterpret_cast<SlotHeader*>(m_mapping + std::size_t(slot) * m_slotSize);
+}
+
+bool SnapshotFile::isSlotValid(int slot) const
+{
+	const SlotHeader* header = getSlotHeader(slot);
+	return header->magic == slotMagic && header->size <= m_capacity && header->generation > 0 &&
+		header->checksum == computeChecksum(header);
+}
+
+std::uint32_t SnapshotFile::computeChecksum(const SlotHeader* header)
+{
+	//the size and generation, then the snapshot bytes:
+	std::uint32_t fields[3];
+	fields[0] = header->size;
+	std::memcpy(&fields[1], &header->generation, sizeof(header->generation));
+	return MathModule::getChecksum(fields, sizeof(fields)) ^
+		MathModule::getChecksum(header + 1, header->size);
+}
+
+void SnapshotFile::publishSlot(int slot, std::size_t size)
+{
+	SlotHeader* header = getSlotHeader(slot);
+	header->magic = slotMagic;
+	header->size = std::uint32_t(size < m_capacity ? size : m_capacity);
+	header->generation = ++m_generation;
+	header->reserved = 0;
+	header->checksum = computeChecksum(header);
+
+	m_syncing[slot] = true;
+	m_lastSlot = slot;
+	m_stats.written++;
+}
+
+void SnapshotFile::syncLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_syncCondition.wait(lock, [this]() {
+			return m_stopping || m_syncing[0] || m_syncing[1] || (m_hasPending && m_writingSlot < 0);
+		});
+
+		//the snapshot written while the previous one was being synced, to the free slot:
+		if (m_hasPending && m_writingSlot < 0 && !m_syncing[0] && !m_syncing[1]) {
+			int slot = m_lastSlot == 0 ? 1 : 0;
+			std::memcpy(getSlotHeader(slot) + 1, m_pendingSnapshot.data(), m_pendingSize);
+			publishSlot(slot, m_pendingSize);
+			m_hasPending = false;
+		}
+		if (m_stopping && !m_syncing[0] && !m_syncing[1] && !m_hasPending) {
+			break;
+		}
+
+		for (int slot = 0; slot < 2; slot++) {
+			if (m_syncing[slot]) {
+				lock.unlock();
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				::msync(getSlotHeader(slot), m_slotSize, MS_SYNC);
+				double syncTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				lock.lock();
+
+				m_syncing[slot] = false;
+				m_stats.synced++;
+				m_stats.syncTime += syncTime;
+			}
+		}
+	}
+}
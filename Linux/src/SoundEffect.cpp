@@ -0,0 +1,34 @@
+/*****************************************************************
+ * \file	SoundEffect.cpp
+ * \brief	Functions and methods for class SoundEffect, to be used with SoundEffect.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "SoundEffect.hpp"
+#include "ResourceManager.hpp"
+
+SoundEffect::SoundEffect(const std::string& path, SoundPool::Priority priority) :
+	m_buffer(ResourceManager::getSoundBuffer(path)),
+	m_priority(priority),
+	m_lastVoice(0)
+{
+}
+
+void SoundEffect::play()
+{
+	m_lastVoice = SoundPool::play(m_buffer, m_priority);
+}
+
+void SoundEffect::uninterruptedPlay()
+{
+	if (!SoundPool::isPlaying(m_lastVoice)) {
+		play();
+	}
+}
+
+void SoundEffect::stop()
+{
+	SoundPool::stop(m_lastVoice);
+}
@@ -0,0 +1,110 @@
+/*****************************************************************
+ * \file	SoundPool.cpp
+ * \brief	Functions and methods for class SoundPool, to be used with SoundPool.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "SoundPool.hpp"
+
+SoundPool::SoundPool() :
+	m_voices(16),
+	m_nextId(1)
+{
+}
+
+SoundPool& SoundPool::getInstance()
+{
+	static SoundPool instance;
+	return instance;
+}
+
+void SoundPool::setVoiceCount(std::size_t voices)
+{
+	SoundPool& instance = getInstance();
+	for (Voice& voice : instance.m_voices) {
+		voice.sound.stop();
+	}
+	instance.m_voices.clear();
+	instance.m_voices.resize(voices);
+}
+
+SoundPool::VoiceId SoundPool::play(boost::shared_ptr<sf::SoundBuffer> buffer, Priority priority)
+{
+	SoundPool& instance = getInstance();
+	if (buffer == nullptr || instance.m_voices.empty()) {
+		return 0;
+	}
+
+	//prefer a free voice, otherwise the lowest priority, oldest, busy voice:
+	Voice* chosenVoice = nullptr;
+	for (Voice& voice : instance.m_voices) {
+		if (voice.sound.getStatus() != sf::SoundSource::Playing) {
+			chosenVoice = &voice;
+			break;
+		}
+		if (chosenVoice == nullptr || voice.priority < chosenVoice->priority ||
+			(voice.priority == chosenVoice->priority && voice.id < chosenVoice->id)) {
+			chosenVoice = &voice;
+		}
+	}
+
+	if (chosenVoice->sound.getStatus() == sf::SoundSource::Playing) {
+		if (chosenVoice->priority > priority) {
+			instance.m_stats.dropped++;
+			return 0;
+		}
+		chosenVoice->sound.stop();
+		instance.m_stats.stolen++;
+	}
+
+	chosenVoice->buffer = buffer;
+	chosenVoice->sound.setBuffer(*buffer);
+	chosenVoice->priority = priority;
+	chosenVoice->id = instance.m_nextId++;
+	chosenVoice->sound.play();
+	instance.m_stats.played++;
+
+	return chosenVoice->id;
+}
+
+bool SoundPool::isPlaying(VoiceId voiceId)
+{
+	Voice* voice = getInstance().findVoice(voiceId);
+	return voice != nullptr && voice->sound.getStatus() == sf::SoundSource::Playing;
+}
+
+void SoundPool::stop(VoiceId voiceId)
+{
+	Voice* voice = getInstance().findVoice(voiceId);
+	if (voice != nullptr) {
+		voice->sound.stop();
+	}
+}
+
+SoundPool::Stats SoundPool::getStats()
+{
+	SoundPool& instance = getInstance();
+
+	Stats stats = instance.m_stats;
+	stats.voices = instance.m_voices.size();
+	for (const Voice& voice : instance.m_voices) {
+		if (voice.sound.getStatus() == sf::SoundSource::Playing) {
+			stats.playing++;
+		}
+	}
+	return stats;
+}
+
+SoundPool::Voice* SoundPool::findVoice(VoiceId voiceId)
+{
+	if (voiceId != 0) {
+		for (Voice& voice : m_voices) {
+			if (voice.id == voiceId) {
+				return &voice;
+			}
+		}
+	}
+	return nullptr;
+}
@@ -7,7 +7,8 @@
 ******************************************************************/
 
 #include "TextShape.hpp"
-#include "CustomSound.hpp"
+#include "SoundEffect.hpp"
+#include "ResourceManager.hpp"
 
 TextShape::TextShape(const std::string& content, const sf::Vector2f& pos,
 	const sf::Vector2f& size, int contentSize, const sf::Color& textColor, const sf::Color& backgroundColor) :
@@ -16,8 +17,6 @@ TextShape::TextShape(const std::string& content, const sf::Vector2f& pos,
 {
 
 	//setup text:
-	std::string path = "MyResources/Fonts/arial.ttf";
-	resetFont(path);
 	p_text.setString(content);
 
 	if (contentSize <= 0) {
@@ -26,6 +25,9 @@ TextShape::TextShape(const std::string& content, const sf::Vector2f& pos,
 	else {
 		p_text.setCharacterSize(contentSize);
 	}
+
+	std::string path = "MyResources/Fonts/arial.ttf";
+	resetFont(path);
 	//p_text.setFillColor(textColor);
 	float xPos = pos.x - (p_text.getLocalBounds().width / 2);
 	float yPos = pos.y - (p_text.getLocalBounds().height);
@@ -34,11 +36,11 @@ TextShape::TextShape(const std::string& content, const sf::Vector2f& pos,
 
 void TextShape::resetFont(const std::string& path)
 {
-	if (!p_font.loadFromFile(path)) {
-		throw("CAN'T LOAD FONT: " + path);
-	}
-	p_text.setFont(p_font);
+	//shared, parsed only once
+	p_font = ResourceManager::getFont(path, p_text.getCharacterSize());
+	p_text.setFont(*p_font);
 	p_text.setStyle(sf::Text::Regular);
+	markDirty();
 }
 
 void TextShape::resetPositon(const sf::Vector2f& pos)
@@ -47,6 +49,7 @@ void TextShape::resetPositon(const sf::Vector2f& pos)
 	float xPos = pos.x - (p_text.getLocalBounds().width / 2);
 	float yPos = pos.y - (p_text.getLocalBounds().height);
 	p_text.setPosition({ xPos, yPos });
+	markDirty();
 }
 
 void TextShape::resetContent(const std::string& content)
@@ -57,6 +60,7 @@ void TextShape::resetContent(const std::string& content)
 	float xPos = p_rectangleShape.getPosition().x - (p_text.getLocalBounds().width / 2);
 	float yPos = p_rectangleShape.getPosition().y - (p_text.getLocalBounds().height);
 	p_text.setPosition({ xPos, yPos });
+	markDirty();
 
 	//use sound effect
 	if (p_updateSound != nullptr && p_updateTextSoundActive) {
@@ -65,17 +69,43 @@ void TextShape::resetContent(const std::string& content)
 }
 void TextShape::setUpdateSound(const std::string& path, bool activate)
 {
-	p_updateSound.reset(new CustomSound(path));
+	p_updateSound.reset(new SoundEffect(path, SoundPool::Normal));
 	enableTextUpdateSound(activate);
 }
 void TextShape::enableTextUpdateSound(bool enable) {
 	p_updateTextSoundActive = enable;
 }
 
-void TextShape::drawTo(sf::RenderWindow* window)
+void TextShape::drawTo(sf::RenderTarget* target)
+{
+	if (target != nullptr) {
+		target->draw(p_rectangleShape);
+		target->draw(p_text);
+	}
+}
+
+std::size_t TextShape::getDrawPassCount() const
+{
+	return 2;
+}
+
+const sf::Texture* TextShape::getDrawPassTexture(std::size_t pass) const
+{
+	if (pass == 0) {
+		return p_rectangleShape.getTexture();
+	}
+	//the glyphs of each character size are on their own texture:
+	return p_font != nullptr ? &p_font->getTexture(p_text.getCharacterSize()) : nullptr;
+}
+
+void TextShape::drawPassTo(sf::RenderTarget* target, std::size_t pass)
 {
-	if (window != nullptr) {
-		window->draw(p_rectangleShape);
-		window->draw(p_text);
+	if (target != nullptr) {
+		if (pass == 0) {
+			target->draw(p_rectangleShape);
+		}
+		else {
+			target->draw(p_text);
+		}
 	}
 }
\ No newline at end of file
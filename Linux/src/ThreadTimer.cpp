@@ -0,0 +1,53 @@
+/*****************************************************************
+ * \file	ThreadTimer.cpp
+ * \brief	Functions and methods for class ThreadTimer, to be used with ThreadTimer.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "ThreadTimer.hpp"
+
+double ThreadTimer::Stats::getUtilization() const
+{
+	return wallTime > 0 ? busyTime / wallTime : 0;
+}
+
+double ThreadTimer::Stats::getAverageTime() const
+{
+	return iterations > 0 ? busyTime / iterations : 0;
+}
+
+ThreadTimer::ThreadTimer() :
+	m_started(false),
+	m_iterations(0),
+	m_busyNanoseconds(0),
+	m_wallNanoseconds(0)
+{
+}
+
+void ThreadTimer::begin()
+{
+	m_iterationStart = Clock::now();
+	if (!m_started.load(std::memory_order_relaxed)) {
+		m_start = m_iterationStart;
+		m_started.store(true, std::memory_order_relaxed);
+	}
+}
+
+void ThreadTimer::end()
+{
+	Clock::time_point now = Clock::now();
+	m_busyNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_iterationStart).count(), std::memory_order_relaxed);
+	m_wallNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count(), std::memory_order_relaxed);
+	m_iterations.fetch_add(1, std::memory_order_relaxed);
+}
+
+ThreadTimer::Stats ThreadTimer::getStats() const
+{
+	Stats stats;
+	stats.iterations = m_iterations.load(std::memory_order_relaxed);
+	stats.busyTime = m_busyNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+	stats.wallTime = m_wallNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+	return stats;
+}
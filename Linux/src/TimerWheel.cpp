@@ -0,0 +1,242 @@
+/*****************************************************************
+ * \file	TimerWheel.cpp
+ * \brief	Functions and methods for class TimerWheel, to be used with TimerWheel.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+//defined, as they are bound to references (std::fill, std::max):
+const unsigned TimerWheel::slotBits;
+const std::uint32_t TimerWheel::slotCount;
+const unsigned TimerWheel::levelCount;
+const std::uint32_t TimerWheel::none;
+const std::uint32_t TimerWheel::firing;
+
+TimerWheel::TimerWheel(double tickTime) :
+	m_tickTime(tickTime),
+	m_time(0),
+	m_tick(0),
+	m_freeTimer(none),
+	m_pendingCount(0),
+	m_nextSequence(0)
+{
+	std::fill(m_slots, m_slots + levelCount * slotCount, none);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(double time, const Delegate<void()>& callback)
+{
+	std::uint32_t index = m_freeTimer;
+	if (index != none) {
+		m_freeTimer = m_timers[index].next;
+	}
+	else {
+		index = std::uint32_t(m_timers.size());
+		m_timers.push_back(Timer());
+		m_timers[index].generation = 0;
+	}
+
+	Timer& timer = m_timers[index];
+	timer.time = time;
+	timer.tick = getTick(time);
+	timer.sequence = m_nextSequence++;
+	timer.callback = callback;
+	insert(index);
+
+	m_pendingCount++;
+	m_stats.scheduled++;
+	return (TimerId(timer.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(TimerId timerId)
+{
+	const std::uint32_t index = std::uint32_t(timerId) - 1;
+	if (timerId == 0 || index >= m_timers.size() || m_timers[index].generation != std::uint32_t(timerId >> 32) ||
+		m_timers[index].slot == none) {
+		return false;
+	}
+
+	//a timer taken to be fired is only released, the firing loop skips it:
+	if (m_timers[index].slot != firing) {
+		unlink(index);
+	}
+	release(index);
+	m_pendingCount--;
+	m_stats.cancelled++;
+	return true;
+}
+
+void TimerWheel::advance(double time)
+{
+	if (time < m_time) {
+		return;
+	}
+	const std::uint64_t tick = getTick(time);
+	m_time = time;
+
+	for (;;) {
+		fire(time, tick);
+		if (m_tick >= tick) {
+			break;
+		}
+
+		//nothing pending, no slot to visit:
+		if (m_pendingCount == 0) {
+			m_tick = tick;
+			break;
+		}
+
+		//enter the next tick, moving down the timers of the coarser slots it begins:
+		m_tick++;
+		for (unsigned level = levelCount - 1; level > 0; level--) {
+			if ((m_tick & ((std::uint64_t(1) << (level * slotBits)) - 1)) == 0) {
+				cascade(level);
+			}
+		}
+	}
+}
+
+void TimerWheel::reset(double time)
+{
+	for (std::uint32_t index = 0; index < m_timers.size(); index++) {
+		if (m_timers[index].slot != none) {
+			release(index);
+		}
+	}
+	std::fill(m_slots, m_slots + levelCount * slotCount, none);
+	m_pendingCount = 0;
+	m_time = time;
+	m_tick = getTick(time);
+}
+
+double TimerWheel::getTime() const
+{
+	return m_time;
+}
+
+std::size_t TimerWheel::getPendingCount() const
+{
+	return m_pendingCount;
+}
+
+const TimerWheel::Stats& TimerWheel::getStats() const
+{
+	return m_stats;
+}
+
+std::uint64_t TimerWheel::getTick(double time) const
+{
+	return time > 0 ? std::uint64_t(time / m_tickTime) : 0;
+}
+
+void TimerWheel::insert(std::uint32_t index)
+{
+	Timer& timer = m_timers[index];
+
+	//a tick already past goes to the current one; one beyond the wheel goes to its last slot, and comes down as the wheel turns
+	const std::uint64_t range = std::uint64_t(1) << (levelCount * slotBits);
+	std::uint64_t tick = std::max(timer.tick, m_tick);
+	if (tick - m_tick >= range) {
+		tick = m_tick + range - 1;
+	}
+
+	unsigned level = 0;
+	while (level + 1 < levelCount && tick - m_tick >= (std::uint64_t(1) << ((level + 1) * slotBits))) {
+		level++;
+	}
+	const std::uint32_t slot = level * slotCount + std::uint32_t((tick >> (level * slotBits)) & (slotCount - 1));
+
+	timer.slot = slot;
+	timer.previous = none;
+	timer.next = m_slots[slot];
+	if (timer.next != none) {
+		m_timers[timer.next].previous = index;
+	}
+	m_slots[slot] = index;
+}
+
+void TimerWheel::unlink(std::uint32_t index)
+{
+	Timer& timer = m_timers[index];
+	if (timer.previous != none) {
+		m_timers[timer.previous].next = timer.next;
+	}
+	else {
+		m_slots[timer.slot] = timer.next;
+	}
+	if (timer.next != none) {
+		m_timers[timer.next].previous = timer.previous;
+	}
+}
+
+void TimerWheel::release(std::uint32_t index)
+{
+	Timer& timer = m_timers[index];
+	timer.callback = Delegate<void()>();
+	timer.slot = none;
+	timer.generation++;
+	timer.next = m_freeTimer;
+	m_freeTimer = index;
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+	const std::uint32_t slot = level * slotCount + std::uint32_t((m_tick >> (level * slotBits)) & (slotCount - 1));
+	std::uint32_t index = m_slots[slot];
+	m_slots[slot] = none;
+
+	while (index != none) {
+		const std::uint32_t next = m_timers[index].next;
+		insert(index);
+		m_stats.cascaded++;
+		index = next;
+	}
+}
+
+void TimerWheel::fire(double time, std::uint64_t tick)
+{
+	const std::uint32_t slot = std::uint32_t(m_tick & (slotCount - 1));
+
+	//repeated while the callbacks schedule timers already due:
+	for (;;) {
+		m_firing.clear();
+		for (std::uint32_t index = m_slots[slot]; index != none;) {
+			Timer& timer = m_timers[index];
+			const std::uint32_t next = timer.next;
+			if (m_tick < tick || timer.time <= time) {
+				unlink(index);
+				timer.slot = firing;
+				m_firing.push_back((TimerId(timer.generation) << 32) | (index + 1));
+			}
+			index = next;
+		}
+		if (m_firing.empty()) {
+			return;
+		}
+
+		std::sort(m_firing.begin(), m_firing.end(), [this](TimerId a, TimerId b) {
+			const Timer& timerA = m_timers[std::uint32_t(a) - 1];
+			const Timer& timerB = m_timers[std::uint32_t(b) - 1];
+			return timerA.time < timerB.time || (timerA.time == timerB.time && timerA.sequence < timerB.sequence);
+		});
+
+		for (std::size_t i = 0; i < m_firing.size(); i++) {
+			//skip the ones cancelled by an earlier callback:
+			const std::uint32_t index = std::uint32_t(m_firing[i]) - 1;
+			if (m_timers[index].generation != std::uint32_t(m_firing[i] >> 32) || m_timers[index].slot != firing) {
+				continue;
+			}
+
+			//released before the call, so the callback may schedule into its entry:
+			Delegate<void()> callback = m_timers[index].callback;
+			release(index);
+			m_pendingCount--;
+			m_stats.fired++;
+			callback();
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/*****************************************************************
+ * \file	WindowInterface.cpp
+ * \brief	Functions and methods for class WindowInterface, to be used with WindowInterface.hpp
+ *
+ * \author	Pedro Lino
+ * \date	July 2022
+******************************************************************/
+
+#include "WindowInterface.hpp"
+
+WindowInterface::WindowInterface() :
+	m_dirty(true)
+{}
+
+std::size_t WindowInterface::getDrawPassCount() const
+{
+	return 1;
+}
+
+const sf::Texture* WindowInterface::getDrawPassTexture(std::size_t /*pass*/) const
+{
+	return nullptr;
+}
+
+void WindowInterface::drawPassTo(sf::RenderTarget* target, std::size_t /*pass*/)
+{
+	drawTo(target);
+}
+
+bool WindowInterface::takeDirty()
+{
+	const bool dirty = m_dirty;
+	m_dirty = false;
+	return dirty;
+}
+
+void WindowInterface::markDirty()
+{
+	m_dirty = true;
+}
@@ -14,7 +14,11 @@
 WindowModel::WindowModel(const std::string& title, const sf::Vector2u& size) :
 	sf::RenderWindow(sf::VideoMode(size.x,size.y), title,
 		sf::Style::Close | sf::Style::Titlebar), //TODO: | sf::Style::Resize no resize!
-	m_originalSize(size)
+	m_originalSize(size),
+	m_layerCacheEnabled(false),
+	m_lastCachedLayer(l2),
+	m_layerCacheInvalid(true),
+	m_layerCacheRedraws(0)
 {
 	sf::View view({ 0.5f * size.x, 0.5f * size.y }, { float(size.x), float(size.y) });
 	this->setView(view);
@@ -36,9 +40,13 @@ void WindowModel::onResize()
 	RenderWindow::onResize();*/
 }
 
-void WindowModel::addChild(boost::shared_ptr<WindowInterface> child)
+void WindowModel::addChild(boost::shared_ptr<WindowInterface> child, Layer layer)
 {
-	m_children.push_back(child);
+	m_children.push_back({ child, layer });
+	m_renderQueue.add(child, layer);
+	if (m_layerCacheEnabled && layer <= m_lastCachedLayer) {
+		m_layerCacheInvalid = true;
+	}
 }
 
 void WindowModel::removeButtons(std::vector<boost::shared_ptr<ButtonInterface>> buttons)
@@ -53,9 +61,63 @@ void WindowModel::removeButtons(std::vector<boost::shared_ptr<ButtonInterface>>
 
 void WindowModel::drawChildren()
 {
-	for (boost::shared_ptr<WindowInterface>& child : m_children) {
-		if (child != nullptr) {
-			child->drawTo(this);
+	m_renderQueue.beginFrame();
+	if (m_layerCacheEnabled) {
+		//every cached child is checked, so that all their flags are cleared:
+		bool dirty = m_layerCacheInvalid;
+		for (std::pair<boost::shared_ptr<WindowInterface>, Layer>& child : m_children) {
+			if (child.first != nullptr && child.second <= m_lastCachedLayer && child.first->takeDirty()) {
+				dirty = true;
+			}
+		}
+
+		if (dirty) {
+			m_layerCache->setView(this->getView());
+			m_layerCache->clear();
+			m_renderQueue.draw(m_layerCache.get(), l0, m_lastCachedLayer);
+			m_layerCache->display();
+			m_layerCacheInvalid = false;
+			m_layerCacheRedraws++;
+		}
+
+		//opaque, copied without blending:
+		this->draw(m_layerCacheSprite, sf::RenderStates(sf::BlendNone));
+		m_renderQueue.recordDraw(this, &m_layerCache->getTexture());
+	}
+
+	m_renderQueue.draw(this, m_layerCacheEnabled ? m_lastCachedLayer + 1 : l0, l5);
+}
+
+bool WindowModel::enableLayerCache(bool enable, Layer lastLayer)
+{
+	if (enable && m_layerCache == nullptr) {
+		boost::shared_ptr<sf::RenderTexture> layerCache(new sf::RenderTexture());
+		if (!layerCache->create(m_originalSize.x, m_originalSize.y)) {
+			enable = false;
+		}
+		else {
+			m_layerCache = layerCache;
+			m_layerCacheSprite.setTexture(m_layerCache->getTexture(), true);
 		}
 	}
+
+	m_layerCacheEnabled = enable;
+	m_lastCachedLayer = lastLayer;
+	m_layerCacheInvalid = true;
+	return m_layerCacheEnabled;
+}
+
+void WindowModel::invalidateLayerCache()
+{
+	m_layerCacheInvalid = true;
+}
+
+std::size_t WindowModel::getLayerCacheRedrawCount() const
+{
+	return m_layerCacheRedraws;
+}
+
+const RenderQueue& WindowModel::getRenderQueue() const
+{
+	return m_renderQueue;
 }
\ No newline at end of file